@@ -0,0 +1,358 @@
+/* headless benchmarks for the hot paths, linked against astro.o and workers.o without the window or GL.
+   build with `make bench` and run from the repo root:
+
+     bin/bench [clock|propagate|passes|all] [catalog.tle]
+
+   without a catalog the propagate and pass sections write a synthetic one (bench_catalog.tle, fixed
+   seed), so runs from different commits see the same sats. figures are wall clock on whatever box it
+   runs on, so only compare runs made on the same one */
+#include "../src/astro.h"
+#include "../src/workers.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* astro.c only draws through this from the footprint helpers, which never run headless */
+void DrawLineEx(Vector2 start, Vector2 end, float thick, Color color) {}
+
+Marker home_location = {"Bench", 52.0f, 5.0f, 0.0f, false};
+
+#define BENCH_CATALOG "bench_catalog.tle"
+#define BENCH_CATALOG_SIZE 6000
+
+static volatile double bench_sink; /* keeps the loops from being optimized away */
+
+static unsigned int bench_rng = 7;
+
+static double bench_uniform(double lo, double hi)
+{
+    bench_rng = bench_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (bench_rng >> 8) / 16777216.0;
+}
+
+static char tle_checksum(const char *line)
+{
+    int sum = 0;
+    for (int i = 0; i < 68 && line[i]; i++)
+    {
+        if (line[i] >= '0' && line[i] <= '9')
+            sum += line[i] - '0';
+        else if (line[i] == '-')
+            sum++;
+    }
+    return (char)('0' + sum % 10);
+}
+
+/* roughly the shape of a real catalog: mostly LEO, then GEO, MEO and a few eccentric transfer orbits,
+   epochs spread over the 40 days before mid october 2026 */
+static bool write_synthetic_catalog(const char *filename, int count)
+{
+    FILE *f = fopen(filename, "w");
+    if (!f)
+        return false;
+    for (int k = 0; k < count; k++)
+    {
+        double r = bench_uniform(0, 1), inc, n, e;
+        if (r < 0.55)
+        {
+            inc = bench_uniform(0, 100);
+            n = bench_uniform(13.5, 16.2);
+            e = bench_uniform(0, 0.02);
+        }
+        else if (r < 0.7)
+        {
+            inc = bench_uniform(50, 65);
+            n = bench_uniform(1.9, 2.3);
+            e = bench_uniform(0, 0.02);
+        }
+        else if (r < 0.8)
+        {
+            inc = bench_uniform(0, 65);
+            n = bench_uniform(2.0, 3.5);
+            e = bench_uniform(0.5, 0.74);
+        }
+        else
+        {
+            inc = bench_uniform(0, 15);
+            n = bench_uniform(0.98, 1.02);
+            e = bench_uniform(0, 0.01);
+        }
+        double raan = bench_uniform(0, 360), argp = bench_uniform(0, 360), ma = bench_uniform(0, 360);
+        double doy = bench_uniform(250, 291);
+
+        char l1[80], l2[80];
+        snprintf(l1, sizeof(l1), "1 %05dU 98067A   26%012.8f  .00001000  00000-0  10000-3 0  999", 10000 + k, doy);
+        snprintf(l2, sizeof(l2), "2 %05d %8.4f %8.4f %07d %8.4f %8.4f %11.8f%5d", 10000 + k, inc, raan, (int)(e * 1e7), argp, ma, n, 1);
+        l1[68] = tle_checksum(l1);
+        l2[68] = tle_checksum(l2);
+        l1[69] = l2[69] = '\0';
+        fprintf(f, "BENCH %d\n%s\n%s\n", k, l1, l2);
+    }
+    fclose(f);
+    return true;
+}
+
+/* the sim clock as it was before it became days since 1970: YYYYDDD.FFFF, normalized every frame and run
+   through year/leap arithmetic on every conversion. kept here as the reference the clock section
+   compares against */
+static double legacy_normalize_epoch(double epoch)
+{
+    int year = (int)(epoch / 1000.0);
+    double day_of_year = fmod(epoch, 1000.0);
+    while (1)
+    {
+        int days_in_yr = ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0)) ? 366 : 365;
+        if (day_of_year >= days_in_yr + 1.0)
+        {
+            day_of_year -= days_in_yr;
+            year++;
+        }
+        else if (day_of_year < 1.0)
+        {
+            year--;
+            day_of_year += ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0)) ? 366 : 365;
+        }
+        else
+            break;
+    }
+    return (year * 1000.0) + day_of_year;
+}
+
+static double legacy_unix_from_epoch(double epoch)
+{
+    epoch = legacy_normalize_epoch(epoch);
+    int year = (int)(epoch / 1000.0);
+    double day = fmod(epoch, 1000.0);
+    int y = year - 1;
+    int leaps = ((y / 4) - (y / 100) + (y / 400)) - ((1969 / 4) - (1969 / 100) + (1969 / 400));
+    return ((year - 1970) * 365.0 + leaps + (day - 1.0)) * 86400.0;
+}
+
+static double legacy_epoch_to_gmst(double epoch)
+{
+    double jd = (legacy_unix_from_epoch(epoch) / 86400.0) + 2440587.5;
+    double gmst = fmod(280.46061837 + 360.98564736629 * (jd - 2451545.0), 360.0);
+    return gmst < 0 ? gmst + 360.0 : gmst;
+}
+
+static void legacy_epoch_to_datetime_str(double epoch, char *buffer)
+{
+    epoch = legacy_normalize_epoch(epoch);
+    int year = (int)(epoch / 1000.0);
+    double day_of_year = fmod(epoch, 1000.0);
+    int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0))
+        days_in_month[1] = 29;
+    int day = (int)day_of_year;
+    double frac = day_of_year - day;
+    int month = 0;
+    for (int i = 0; i < 12; i++)
+    {
+        if (day <= days_in_month[i])
+        {
+            month = i + 1;
+            break;
+        }
+        day -= days_in_month[i];
+    }
+    double hours = frac * 24.0;
+    int h = (int)hours;
+    double minutes = (hours - h) * 60.0;
+    int m = (int)minutes;
+    sprintf(buffer, "%04d-%02d-%02d %02d:%02d:%02.0f UTC", year, month, day, h, m, (minutes - m) * 60.0);
+}
+
+/* ns per call since t0_ms */
+static double bench_ns(double t0_ms, long n)
+{
+    return (WorkerClockMs() - t0_ms) * 1e6 / (double)n;
+}
+
+/* the per-sample clock work every sweep does (unix seconds for sgp4, gmst for the ECEF rotation), the
+   per-frame normalize the old format needed, date formatting for the UI, and how finely each format can
+   tell two instants apart today */
+static void bench_clock(void)
+{
+    const long n = 20000000;
+    const long n_str = 2000000;
+    double now = unix_to_epoch(1792324800.0);  /* 2026-10-18 */
+    double legacy_now = 2026291.0;
+    char buf[64];
+
+    const double tick = 1.0001 / 86400.0;  /* a bit over a second per call */
+    double sum = 0.0, t0;
+
+    t0 = WorkerClockMs();
+    for (long i = 0; i < n; i++)
+        sum += legacy_unix_from_epoch(legacy_now + i * tick) + legacy_epoch_to_gmst(legacy_now + i * tick);
+    double legacy_conv = bench_ns(t0, n);
+
+    t0 = WorkerClockMs();
+    for (long i = 0; i < n; i++)
+        sum += get_unix_from_epoch(now + i * tick) + epoch_to_gmst(now + i * tick);
+    double conv = bench_ns(t0, n);
+
+    t0 = WorkerClockMs();
+    for (long i = 0; i < n; i++)
+        sum += legacy_normalize_epoch(legacy_now + i * tick);
+    double legacy_norm = bench_ns(t0, n);
+
+    t0 = WorkerClockMs();
+    for (long i = 0; i < n_str; i++)
+        legacy_epoch_to_datetime_str(legacy_now + i * tick, buf);
+    double legacy_str = bench_ns(t0, n_str);
+
+    t0 = WorkerClockMs();
+    for (long i = 0; i < n_str; i++)
+        epoch_to_datetime_str(now + i * tick, buf);
+    double str = bench_ns(t0, n_str);
+
+    bench_sink = sum + buf[0];
+
+    printf("clock (%ld calls, %ld for strings)\n", n, n_str);
+    printf("  unix + gmst per sample:  old %6.1f ns   new %6.1f ns\n", legacy_conv, conv);
+    printf("  per-frame normalize:     old %6.1f ns   new   none\n", legacy_norm);
+    printf("  datetime string:         old %6.1f ns   new %6.1f ns\n", legacy_str, str);
+    printf("  clock resolution today:  old %.1e s     new %.1e s\n", (nextafter(legacy_now, INFINITY) - legacy_now) * 86400.0, (nextafter(now, INFINITY) - now) * 86400.0);
+}
+
+static double bench_elevation(Satellite *sat, double epoch)
+{
+    double az, el, theta = epoch_to_gmst(epoch) * DEG2RAD;
+    observer_look(get_home_frame(), calculate_position(sat, get_unix_from_epoch(epoch)), sin(theta), cos(theta), &az, &el);
+    return el;
+}
+
+/* how passes got refined before the search went to newton on the elevation rate: ten bisection steps per
+   horizon crossing, bracketed by the coarse step, then a 400 point trace for the max elevation. kept here
+   as the reference the pass section compares against */
+static double legacy_bisect(Satellite *sat, double up, double down)
+{
+    for (int k = 0; k < 10; k++)
+    {
+        double mid = 0.5 * (up + down);
+        if (bench_elevation(sat, mid) >= 0.0)
+            up = mid;
+        else
+            down = mid;
+    }
+    return 0.5 * (up + down);
+}
+
+static float legacy_refine(const SatPass *p, double coarse_step)
+{
+    double aos = legacy_bisect(p->sat, p->aos_epoch + coarse_step * 0.5, p->aos_epoch - coarse_step * 0.5);
+    double los = legacy_bisect(p->sat, p->los_epoch - coarse_step * 0.5, p->los_epoch + coarse_step * 0.5);
+    float max_el = -90.0f;
+    for (int k = 0; k < SKY_TRACK_POINTS; k++)
+        max_el = fmaxf(max_el, (float)bench_elevation(p->sat, aos + (los - aos) * k / (SKY_TRACK_POINTS - 1)));
+    return max_el;
+}
+
+/* one frame's near-earth update for the whole catalog: the batch path against sgp4() one sat at a time */
+static void bench_propagate(void)
+{
+    const int frames = 200;
+    for (int i = 0; i < sat_count; i++)
+        sat_active[i] = true;
+    prepare_batch_propagation();
+    int near = get_near_earth_count();
+    double t = satellites[0]->epoch_unix + 3600.0;
+
+    double t0 = WorkerClockMs();
+    for (int f = 0; f < frames; f++)
+        propagate_near_earth(t + f, 0, near);
+    double batch = (WorkerClockMs() - t0) / frames;
+
+    t0 = WorkerClockMs();
+    for (int f = 0; f < frames; f++)
+        for (int i = 0; i < sat_count; i++)
+            if (satellites[i]->satrec.method != 'd')
+                sat_current_pos[i] = calculate_position(satellites[i], t + f);
+    double scalar = (WorkerClockMs() - t0) / frames;
+
+    printf("propagate (%d near-earth sats, one thread)\n", near);
+    printf("  batch:          %6.2f ms per frame   %5.0f ns per sat\n", batch, batch * 1e6 / near);
+    printf("  sgp4() per sat: %6.2f ms per frame   %5.0f ns per sat\n", scalar, scalar * 1e6 / near);
+}
+
+/* single-sat 3 day searches for the first 300 sats, the old refinement redone on every pass they found,
+   and one all-sats search over the first 1000 */
+static void bench_passes(void)
+{
+    const int singles = sat_count < 300 ? sat_count : 300;
+    const int catalog = sat_count < 1000 ? sat_count : 1000;
+    double start = 0.0;
+    for (int i = 0; i < sat_count; i++)
+    {
+        start = fmax(start, satellites[i]->epoch_days);
+        sat_active[i] = i < catalog;
+    }
+
+    PassSearch ps = {0};
+    double search_ms = 0.0, legacy_ms = 0.0;
+    long found = 0;
+    for (int i = 0; i < singles; i++)
+    {
+        double t0 = WorkerClockMs();
+        if (pass_search_begin(&ps, satellites[i], start, 3.0, 0.0f, NULL, 0))
+        {
+            while (!pass_search_step(&ps, INFINITY))
+                ;
+            pass_search_finish(&ps);
+        }
+        search_ms += WorkerClockMs() - t0;
+
+        t0 = WorkerClockMs();
+        for (int k = 0; k < num_passes; k++)
+            bench_sink += legacy_refine(&passes[k], 1.0 / 1440.0);
+        legacy_ms += WorkerClockMs() - t0;
+        found += num_passes;
+    }
+
+    double t0 = WorkerClockMs();
+    if (pass_search_begin(&ps, NULL, start, 3.0, 0.0f, NULL, 0))
+    {
+        while (!pass_search_step(&ps, INFINITY))
+            ;
+        pass_search_finish(&ps);
+    }
+    double all_ms = WorkerClockMs() - t0;
+
+    printf("passes (%d worker threads + main)\n", WorkerPoolThreadCount());
+    printf("  %d single-sat 3 day searches: %ld passes, %.0f ms\n", singles, found, search_ms);
+    printf("  old refinement alone on those passes:  %.0f ms (bisection + %d point trace)\n", legacy_ms, SKY_TRACK_POINTS);
+    printf("  all-sats 3 day search, %d sats:        %d passes, %.0f ms\n", catalog, num_passes, all_ms);
+}
+
+int main(int argc, char **argv)
+{
+    const char *what = argc > 1 ? argv[1] : "all";
+    const char *catalog = argc > 2 ? argv[2] : BENCH_CATALOG;
+    bool all = strcmp(what, "all") == 0;
+
+    if (all || strcmp(what, "clock") == 0)
+        bench_clock();
+
+    bool propagate = all || strcmp(what, "propagate") == 0;
+    if (propagate || strcmp(what, "passes") == 0)
+    {
+        FILE *f = fopen(catalog, "r");
+        if (f)
+            fclose(f);
+        else if (argc > 2 || !write_synthetic_catalog(catalog, BENCH_CATALOG_SIZE))
+        {
+            printf("Failed to open %s\n", catalog);
+            return 1;
+        }
+        WorkerPoolInit(0);
+        load_tle_data(catalog);
+        if (propagate)
+            bench_propagate();
+        if (all || strcmp(what, "passes") == 0)
+            bench_passes();
+        WorkerPoolShutdown();
+    }
+    return 0;
+}
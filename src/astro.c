@@ -1,8 +1,10 @@
 #define _GNU_SOURCE
 #include "astro.h"
 #include "types.h"
+#include "workers.h"
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,16 +33,44 @@ void geodetic_to_ecef(double lat_deg, double lon_deg, double alt_m, double *ox,
     *oz = (N * (1.0 - WGS84_E2) + alt_km) * sin_lat;
 }
 
-Satellite satellites[MAX_SATELLITES];
+Satellite **satellites = NULL;
 int sat_count = 0;
+int sat_capacity = 0;
+
+bool *sat_active = NULL;
+Vector3 *sat_current_pos = NULL;
+Vector2 *sat_screen_pos = NULL;
 
 Marker markers[MAX_MARKERS];
 int marker_count = 0;
 
-SatPass passes[MAX_PASSES];
+/* double buffered: searches copy what they have into the back buffer and flip passes over to it, so
+   passes/num_passes always describe one whole list. both halves grow as needed */
+static SatPass *pass_buffers[2];
+static int pass_buffer_capacity[2];
+SatPass *passes = NULL;
 int num_passes = 0;
+PassObserver pass_observers[PASS_MAX_OBSERVERS];
+int num_pass_observers = 0;
 Satellite *last_pass_calc_sat = NULL;
 
+/* bumped whenever the catalog contents change so derived tables know to rebuild */
+static unsigned int catalog_generation = 1;
+
+/* held by background threads while they look at the catalog and by the loaders while they rewrite it.
+   no-op until start_ephemeris_builder creates it */
+static WorkerMutex *catalog_mutex = NULL;
+
+static void catalog_lock(void)
+{
+    WorkerMutexLock(catalog_mutex);
+}
+
+static void catalog_unlock(void)
+{
+    WorkerMutexUnlock(catalog_mutex);
+}
+
 /* string extraction (sscanf is a bit too beefy for tight TLE loops) */
 static double parse_tle_double(const char *str, int start, int len)
 {
@@ -49,72 +79,41 @@ static double parse_tle_double(const char *str, int start, int len)
     return atof(buf);
 }
 
-/* pulls the system clock and mashes it into our custom YYYYDDD.FFFF format */
+/* the sim clock ("epoch" all over the place) is days since 1970-01-01 UTC. it's monotonic, there's no
+   year rollover to babysit, and unix seconds are one multiply away, so none of the propagation loops have
+   to think about calendars. dates only come into it for display and when reading TLEs */
+#define UNIX_EPOCH_JD 2440587.5
+
+/* pulls the system clock */
 double get_current_real_time_epoch(void)
 {
-    time_t now = time(NULL);
-    struct tm *gmt = gmtime(&now);
-
-    int year = gmt->tm_year + 1900;
-    double day_of_year = gmt->tm_yday + 1.0;
-    double fraction_of_day = (gmt->tm_hour + gmt->tm_min / 60.0 + gmt->tm_sec / 3600.0) / 24.0;
-
-    /* modified to return full YYYY format to make global time sim less fuckywucky,
-       afterwards we just use the YY format for SGP4 data. */
-    return (year * 1000.0) + day_of_year + fraction_of_day;
+    return unix_to_epoch((double)time(NULL));
 }
 
-/* handles year rollover/underflow so the math doesnt explode when looking at past/future passes */
-double normalize_epoch(double epoch)
+/* epoch to unix time for sgp4 math */
+double get_unix_from_epoch(double epoch)
 {
-    int year = (int)(epoch / 1000.0);
-    double day_of_year = fmod(epoch, 1000.0);
-
-    while (1)
-    {
-        int days_in_yr = ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0)) ? 366 : 365;
-
-        if (day_of_year >= days_in_yr + 1.0)
-        {
-            day_of_year -= days_in_yr;
-            year++;
-        }
-        else if (day_of_year < 1.0)
-        {
-            year--;
-            int prev_days_in_yr = ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0)) ? 366 : 365;
-            day_of_year += prev_days_in_yr;
-        }
-        else
-        {
-            break;
-        }
-    }
-    return (year * 1000.0) + day_of_year;
+    return epoch * 86400.0;
 }
 
-/* utility to convert normalized epoch format to unix time for sgp4 math */
-double get_unix_from_epoch(double epoch)
+double unix_to_epoch(double target_unix)
 {
-    epoch = normalize_epoch(epoch);
-    int year = (int)(epoch / 1000.0);
-    double day = fmod(epoch, 1000.0);
+    return target_unix / 86400.0;
+}
 
-    /* pure mathematical unix conversion to avoid OS-level timegm() quantization and stutter */
+/* days from 1970-01-01 to jan 1st of year, pure math to avoid OS-level timegm() quantization */
+static double days_before_year(int year)
+{
     int y = year - 1;
     int leaps_to_year = (y / 4) - (y / 100) + (y / 400);
     int leaps_to_1970 = (1969 / 4) - (1969 / 100) + (1969 / 400);
-    int leaps = leaps_to_year - leaps_to_1970;
-
-    double unix_days = (year - 1970) * 365.0 + leaps + (day - 1.0);
-    return unix_days * 86400.0;
+    return (year - 1970) * 365.0 + (leaps_to_year - leaps_to_1970);
 }
 
 /* sidereal time keeps the earth spinning under the sats; without this, everything is static */
 double epoch_to_gmst(double epoch)
 {
-    double unix_time = get_unix_from_epoch(epoch);
-    double jd = (unix_time / 86400.0) + 2440587.5;
+    double jd = epoch + UNIX_EPOCH_JD;
 
     double gmst = fmod(280.46061837 + 360.98564736629 * (jd - 2451545.0), 360.0);
     if (gmst < 0)
@@ -122,44 +121,138 @@ double epoch_to_gmst(double epoch)
     return gmst;
 }
 
+/* over a sweep gmst is just a straight line in time, so it gets computed properly once and then rotated
+   forward by a fixed angle per step. sin/cos ride along through the angle addition formulas, and every
+   GMST_SWEEP_RESYNC steps it all gets recomputed exactly so rounding can't build up */
+#define GMST_DEG_PER_DAY 360.98564736629
+#define GMST_SWEEP_RESYNC 256
+
+static void gmst_sweep_sync(GmstSweep *sw)
+{
+    sw->gmst_deg = epoch_to_gmst(sw->epoch);
+    double theta = sw->gmst_deg * DEG2RAD;
+    sw->sin_theta = sin(theta);
+    sw->cos_theta = cos(theta);
+    sw->since_sync = 0;
+}
+
+void gmst_sweep_begin(GmstSweep *sw, double start_epoch, double step_days)
+{
+    sw->epoch = start_epoch;
+    sw->step_days = step_days;
+    sw->step_deg = fmod(GMST_DEG_PER_DAY * step_days, 360.0);
+    sw->sin_step = sin(sw->step_deg * DEG2RAD);
+    sw->cos_step = cos(sw->step_deg * DEG2RAD);
+    gmst_sweep_sync(sw);
+}
+
+void gmst_sweep_next(GmstSweep *sw)
+{
+    sw->epoch += sw->step_days;
+    if (++sw->since_sync >= GMST_SWEEP_RESYNC)
+    {
+        gmst_sweep_sync(sw);
+        return;
+    }
+
+    sw->gmst_deg += sw->step_deg;
+    if (sw->gmst_deg >= 360.0)
+        sw->gmst_deg -= 360.0;
+    else if (sw->gmst_deg < 0.0)
+        sw->gmst_deg += 360.0;
+
+    double s = sw->sin_theta * sw->cos_step + sw->cos_theta * sw->sin_step;
+    double c = sw->cos_theta * sw->cos_step - sw->sin_theta * sw->sin_step;
+    sw->sin_theta = s;
+    sw->cos_theta = c;
+}
+
 /* pretty-print for the ui so humans can actually read the time */
 void epoch_to_datetime_str(double epoch, char *buffer)
 {
-    epoch = normalize_epoch(epoch);
-    int year = (int)(epoch / 1000.0);
-    double day_of_year = fmod(epoch, 1000.0);
+    /* round to the second up front, otherwise 59.7s prints as :60 */
+    double whole_secs = floor(epoch * 86400.0 + 0.5);
+    double whole_days = floor(whole_secs / 86400.0);
+    int sec_of_day = (int)(whole_secs - whole_days * 86400.0);
+
+    /* days to civil date, counted in 400 year eras with the year starting in march so the leap day
+       lands at the very end */
+    long z = (long)whole_days + 719468;
+    long era = (z >= 0 ? z : z - 146096) / 146097;
+    long doe = z - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    int day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    int month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    int year = (int)(yoe + era * 400 + (month <= 2 ? 1 : 0));
+
+    sprintf(buffer, "%04d-%02d-%02d %02d:%02d:%02d UTC", year, month, day, sec_of_day / 3600, (sec_of_day / 60) % 60, sec_of_day % 60);
+}
 
-    int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    if ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0))
-        days_in_month[1] = 29;
+/* catalog storage: records are handed out of fixed-size chunks that are never moved or freed, and
+   satellites[] is just a table of pointers into them. the table and the hot arrays get realloc'd as the
+   catalog grows but Satellite * handles stay put, and a reload reuses the same records */
+#define SAT_ARENA_CHUNK 1024
 
-    int day = (int)day_of_year;
-    double frac = day_of_year - day;
+static bool catalog_grow(void)
+{
+    int cap = sat_capacity + SAT_ARENA_CHUNK;
+    Satellite *chunk = calloc(SAT_ARENA_CHUNK, sizeof(Satellite));
+    if (!chunk)
+        return false;
 
-    int month = 0;
-    for (int i = 0; i < 12; i++)
+    Satellite **table = realloc(satellites, cap * sizeof(Satellite *));
+    if (!table)
     {
-        if (day <= days_in_month[i])
-        {
-            month = i + 1;
-            break;
-        }
-        day -= days_in_month[i];
+        free(chunk);
+        return false;
+    }
+    satellites = table;
+
+    bool *active = realloc(sat_active, cap * sizeof(bool));
+    if (active)
+        sat_active = active;
+    Vector3 *pos = realloc(sat_current_pos, cap * sizeof(Vector3));
+    if (pos)
+        sat_current_pos = pos;
+    Vector2 *screen = realloc(sat_screen_pos, cap * sizeof(Vector2));
+    if (screen)
+        sat_screen_pos = screen;
+    if (!active || !pos || !screen)
+    {
+        free(chunk);
+        return false;
     }
 
-    double hours = frac * 24.0;
-    int h = (int)hours;
-    double minutes = (hours - h) * 60.0;
-    int m = (int)minutes;
-    double seconds = (minutes - m) * 60.0;
-    sprintf(buffer, "%04d-%02d-%02d %02d:%02d:%02.0f UTC", year, month, day, h, m, seconds);
+    for (int i = 0; i < SAT_ARENA_CHUNK; i++)
+        satellites[sat_capacity + i] = &chunk[i];
+    sat_capacity = cap;
+    return true;
 }
 
 /* rips lines from a TLE file and populates the satellite struct */
 bool add_satellite_from_tle(const char* line0, const char* line1, const char* line2)
 {
-    if (sat_count >= MAX_SATELLITES) return false;
-    Satellite *sat = &satellites[sat_count];
+    if (sat_count >= sat_capacity && !catalog_grow())
+    {
+        printf("Out of memory growing the catalog, skipping everything past %d sats.\n", sat_count);
+        return false;
+    }
+    Satellite *sat = satellites[sat_count];
+    free_deep_space_checkpoints(&sat->ds_checkpoints);
+    if (sat->ephem)
+    {
+        /* same seq bump as ephemeris_publish, a frame worker may be inside ephemeris_eval on this slot */
+        EphemerisWindow *w = sat->ephem;
+        unsigned int seq = w->seq;
+        w->seq = seq + 1;
+        __sync_synchronize();
+        w->valid = false;
+        w->num_segments = 0;
+        __sync_synchronize();
+        w->seq = seq + 2;
+    }
 
     strncpy(sat->name, line0, 24);
     sat->name[24] = '\0';
@@ -189,12 +282,13 @@ bool add_satellite_from_tle(const char* line0, const char* line1, const char* li
         /* shove the TLE into the sgp4 state machine */
         ConvertTLEToSGP4(&sat->satrec, &parsed_objs[0], 0.0, initial_r, initial_v);
         free(parsed_objs);
+        sat->satrec_tle = sat->satrec;
 
         /* manual scraping for the rest of the struct because we like control */
         double raw_epoch = parse_tle_double(line1, 18, 14);
         int yy = (int)(raw_epoch / 1000.0);
         int year = (yy < 57) ? 2000 + yy : 1900 + yy;
-        sat->epoch_days = (year * 1000.0) + fmod(raw_epoch, 1000.0);
+        sat->epoch_days = days_before_year(year) + (fmod(raw_epoch, 1000.0) - 1.0);
         sat->epoch_unix = get_unix_from_epoch(sat->epoch_days);
         sat->inclination = parse_tle_double(line2, 8, 8) * DEG2RAD;
         sat->raan = parse_tle_double(line2, 17, 8) * DEG2RAD;
@@ -209,55 +303,122 @@ bool add_satellite_from_tle(const char* line0, const char* line1, const char* li
         double revs_per_day = parse_tle_double(line2, 52, 11);
         sat->mean_motion = (revs_per_day * 2.0 * PI) / 86400.0;
         sat->semi_major_axis = pow(MU / (sat->mean_motion * sat->mean_motion), 1.0 / 3.0);
-        sat->is_active = true;
+        sat->id = sat_count;
+        sat_active[sat->id] = true;
+        sat_current_pos[sat->id] = (Vector3){0.0f, 0.0f, 0.0f};
+        release_orbit_cache(sat);
+        sat->orbit_wanted_frame = 0;
         sat_count++;
+        catalog_generation++;
         return true;
     }
     return false;
 }
 
-/* bulk loading of celestial junk from flat files */
-void load_tle_data(const char *filename)
+/* bulk loading of celestial junk from flat files. the loader can be fed a few sats at a time so a big
+   catalog doesn't freeze the frame it lands in; the catalog is emptied on open and fills up as it goes */
+bool tle_loader_open(TleLoader *ld, const char *filename, bool activate)
 {
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    ld->file = fopen(filename, "r");
+    if (!ld->file)
     {
         printf("Failed to open %s\n", filename);
-        return;
+        return false;
     }
+    fseek(ld->file, 0, SEEK_END);
+    ld->size = ftell(ld->file);
+    rewind(ld->file);
+    ld->activate = activate;
 
+    catalog_lock();
     sat_count = 0;
-    char line0[256];
+    catalog_generation++;
+    catalog_unlock();
 
     /* Check for custom header to restore TLE Manager state */
-    if (fgets(line0, sizeof(line0), file))
+    char line0[256];
+    if (fgets(line0, sizeof(line0), ld->file))
     {
         if (strncmp(line0, "# EPOCH:", 8) != 0)
         {
-            rewind(file); /* not a header, restart */
+            rewind(ld->file); /* not a header, restart */
         }
     }
+    return true;
+}
+
+/* true once the file is used up. deadline is checked every 16 sats */
+bool tle_loader_step(TleLoader *ld, double deadline_ms)
+{
+    if (!ld->file)
+        return true;
+
+    char line0[256], line1[256], line2[256];
+    int since_check = 0;
+    bool done = false;
 
-    char line1[256], line2[256];
-    while (fgets(line0, sizeof(line0), file))
+    catalog_lock();
+    while (1)
     {
+        if (++since_check >= 16)
+        {
+            since_check = 0;
+            if (WorkerClockMs() >= deadline_ms)
+                break;
+        }
+        if (!fgets(line0, sizeof(line0), ld->file))
+        {
+            done = true;
+            break;
+        }
         if (line0[0] == '#' || line0[0] == '\n' || line0[0] == '\r')
             continue;
 
-        if (fgets(line1, sizeof(line1), file) && fgets(line2, sizeof(line2), file))
+        if (fgets(line1, sizeof(line1), ld->file) && fgets(line2, sizeof(line2), ld->file))
         {
             line0[strcspn(line0, "\r\n")] = 0;
             line1[strcspn(line1, "\r\n")] = 0;
             line2[strcspn(line2, "\r\n")] = 0;
-            add_satellite_from_tle(line0, line1, line2);
+            if (add_satellite_from_tle(line0, line1, line2) && !ld->activate)
+                sat_active[sat_count - 1] = false;
         }
     }
-    fclose(file);
+    catalog_unlock();
+
+    if (done)
+        tle_loader_close(ld);
+    return done;
+}
+
+float tle_loader_progress(const TleLoader *ld)
+{
+    if (!ld->file || ld->size <= 0)
+        return 1.0f;
+    return (float)ftell(ld->file) / ld->size;
+}
+
+void tle_loader_close(TleLoader *ld)
+{
+    if (!ld->file)
+        return;
+    fclose(ld->file);
+    ld->file = NULL;
+    prepare_batch_propagation();
+}
+
+void load_tle_data(const char *filename)
+{
+    TleLoader ld;
+    if (!tle_loader_open(&ld, filename, true))
+        return;
+    while (!tle_loader_step(&ld, INFINITY))
+        ;
 }
 
 /* parsing for strings that were likely copy-pasted in a hurry */
 void load_manual_tles(AppConfig *config)
 {
+    catalog_lock();
     for (int i = 0; i < config->manual_tle_count; i++)
     {
         char temp[512];
@@ -274,366 +435,2702 @@ void load_manual_tles(AppConfig *config)
         *line2 = '\0';
         line2++;
 
-        add_satellite_from_tle(line0, line1, line2);
+        add_satellite_from_tle(line0, line1, line2);
+    }
+    catalog_unlock();
+    prepare_batch_propagation();
+}
+
+/* deep-space resonance checkpoints: sgp4's dspace() integrates in 720 min steps from wherever it last
+   stopped, but restarts from epoch as soon as tsince moves back toward it. scrubbing backwards would
+   re-integrate every resonant GEO/HEO sat from epoch each frame, so we snapshot the integrator once per
+   simulated day and drop the sat onto the nearest snapshot before calling sgp4(). */
+#define DS_CHECKPOINT_MIN 1440.0
+#define DS_MAX_CHECKPOINT_DAYS 36600 /* ~100 years either way, well past where the TLE means anything */
+
+void free_deep_space_checkpoints(DeepSpaceCheckpoints *ck)
+{
+    for (int dir = 0; dir < 2; dir++)
+    {
+        free(ck->days[dir]);
+        ck->days[dir] = NULL;
+        ck->count[dir] = 0;
+        ck->capacity[dir] = 0;
+    }
+}
+
+static void deep_space_seek(struct elsetrec *rec, DeepSpaceCheckpoints *ck, double tsince)
+{
+    if (rec->irez == 0)
+        return;
+
+    double at = rec->atime;
+    bool restart = (at == 0.0) || (tsince * at <= 0.0) || (fabs(tsince) < fabs(at));
+    if (!restart && fabs(tsince) - fabs(at) < DS_CHECKPOINT_MIN)
+        return; /* already within a day of the target, let sgp4 finish the last couple of steps */
+
+    int day = (int)(fabs(tsince) / DS_CHECKPOINT_MIN);
+    if (day > DS_MAX_CHECKPOINT_DAYS)
+        day = DS_MAX_CHECKPOINT_DAYS;
+    if (day == 0)
+        return; /* inside the first day the restart from epoch is just as cheap */
+
+    int dir = (tsince > 0.0) ? 0 : 1;
+    double sign = dir == 0 ? 1.0 : -1.0;
+
+    /* first time out this far; walk from the last snapshot a day at a time, recording as we go */
+    if (ck->count[dir] < day)
+    {
+        if (ck->capacity[dir] < day)
+        {
+            int cap = ck->capacity[dir] ? ck->capacity[dir] : 32;
+            while (cap < day) cap *= 2;
+            if (cap > DS_MAX_CHECKPOINT_DAYS) cap = DS_MAX_CHECKPOINT_DAYS;
+            DeepSpaceCheckpoint *grown = realloc(ck->days[dir], cap * sizeof(DeepSpaceCheckpoint));
+            if (!grown)
+                return;
+            ck->days[dir] = grown;
+            ck->capacity[dir] = cap;
+        }
+
+        if (ck->count[dir] > 0)
+        {
+            DeepSpaceCheckpoint *last = &ck->days[dir][ck->count[dir] - 1];
+            rec->atime = last->atime;
+            rec->xli = last->xli;
+            rec->xni = last->xni;
+        }
+        else
+        {
+            rec->atime = 0.0; /* forces the epoch restart inside dspace */
+        }
+
+        double ro[3], vo[3];
+        while (ck->count[dir] < day)
+        {
+            sgp4(rec, sign * (ck->count[dir] + 1) * DS_CHECKPOINT_MIN, ro, vo);
+            DeepSpaceCheckpoint *c = &ck->days[dir][ck->count[dir]++];
+            c->atime = rec->atime;
+            c->xli = rec->xli;
+            c->xni = rec->xni;
+        }
+    }
+
+    DeepSpaceCheckpoint *c = &ck->days[dir][day - 1];
+    rec->atime = c->atime;
+    rec->xli = c->xli;
+    rec->xni = c->xni;
+}
+
+/* chebyshev ephemeris windows: a background thread runs sgp4 at chebyshev nodes over a few segments
+   around the sim clock and stores the coefficients per sat. calculate_position and the batch path just
+   evaluate the polynomials while the clock is inside a window, and fall through to sgp4 otherwise
+   (outside the window, mid-rewrite, builder off, bad elements). */
+#define EPHEM_BUILDER_BATCH 64
+#define EPHEM_MIN_SEG_LEN 30.0
+#define EPHEM_MAX_SEG_LEN 43200.0
+#define EPHEM_MAX_HALVINGS 8
+
+static WorkerThread *ephem_thread = NULL;
+static volatile bool ephem_quit = false;
+static volatile double ephem_clock_unix = 0.0;
+static volatile float ephem_tolerance_km = 0.0f;
+static EphemerisWindow ephem_scratch; /* builder thread only */
+
+static double cheb_eval(const double *c, double x)
+{
+    double b1 = 0.0, b2 = 0.0;
+    double x2 = 2.0 * x;
+    for (int n = EPHEM_CHEB_COEFFS - 1; n >= 1; n--)
+    {
+        double b0 = x2 * b1 - b2 + c[n];
+        b2 = b1;
+        b1 = b0;
+    }
+    return x * b1 - b2 + c[0];
+}
+
+/* seqlock read; false means "ask sgp4 instead". acquire fences only, a full barrier costs more than the
+   polynomial does */
+static bool ephemeris_eval(const EphemerisWindow *w, double t_unix, double r[3])
+{
+    unsigned int seq = w->seq;
+    if ((seq & 1u) || !w->valid)
+        return false;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    double dt = t_unix - w->t_start;
+    if (dt < 0.0 || dt >= w->seg_len * w->num_segments)
+        return false;
+    int k = (int)(dt / w->seg_len);
+    if (k >= EPHEM_MAX_SEGMENTS)
+        return false;
+    double x = 2.0 * (dt - k * w->seg_len) / w->seg_len - 1.0;
+
+    /* clenshaw on all three axes at once so the chains overlap */
+    const double *cx = w->coef[k][0], *cy = w->coef[k][1], *cz = w->coef[k][2];
+    double x2 = 2.0 * x;
+    double bx1 = 0.0, bx2 = 0.0, by1 = 0.0, by2 = 0.0, bz1 = 0.0, bz2 = 0.0;
+    for (int n = EPHEM_CHEB_COEFFS - 1; n >= 1; n--)
+    {
+        double bx0 = x2 * bx1 - bx2 + cx[n];
+        double by0 = x2 * by1 - by2 + cy[n];
+        double bz0 = x2 * bz1 - bz2 + cz[n];
+        bx2 = bx1; bx1 = bx0;
+        by2 = by1; by1 = by0;
+        bz2 = bz1; bz1 = bz0;
+    }
+    r[0] = x * bx1 - bx2 + cx[0];
+    r[1] = x * by1 - by2 + cy[0];
+    r[2] = x * bz1 - bz2 + cz[0];
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return w->seq == seq;
+}
+
+static bool ephemeris_position(Satellite *sat, double current_unix, Vector3 *out)
+{
+    EphemerisWindow *w = sat->ephem;
+    double r[3];
+    if (!w || ephem_tolerance_km <= 0.0f || !ephemeris_eval(w, current_unix, r))
+        return false;
+
+    out->x = (float)(r[0]);
+    out->y = (float)(r[2]);
+    out->z = (float)(-r[1]);
+    return true;
+}
+
+/* one segment: sgp4 at the N chebyshev nodes, coefficients from the discrete cosine sums, then the
+   residual at the extrema of T_N (between the nodes, where truncation error peaks) */
+static bool ephemeris_fit_segment(struct elsetrec *rec, double epoch_unix, double seg_start, double seg_len,
+                                  double coef[3][EPHEM_CHEB_COEFFS], float *err_km)
+{
+    const int N = EPHEM_CHEB_COEFFS;
+    double samples[EPHEM_CHEB_COEFFS][3];
+    double ro[3], vo[3];
+    double half = 0.5 * seg_len;
+    double mid = seg_start + half;
+
+    /* walk the nodes forward in time so the deep-space integrator keeps stepping instead of restarting */
+    for (int j = N - 1; j >= 0; j--)
+    {
+        double x = cos(SGPPI * (j + 0.5) / N);
+        sgp4(rec, (mid + half * x - epoch_unix) / 60.0, ro, vo);
+        if (rec->error != 0)
+            return false;
+        samples[j][0] = ro[0];
+        samples[j][1] = ro[1];
+        samples[j][2] = ro[2];
+    }
+
+    for (int a = 0; a < 3; a++)
+    {
+        for (int k = 0; k < N; k++)
+        {
+            double sum = 0.0;
+            for (int j = 0; j < N; j++)
+                sum += samples[j][a] * cos(SGPPI * k * (j + 0.5) / N);
+            coef[a][k] = (k == 0 ? 1.0 : 2.0) * sum / N;
+        }
+    }
+
+    double worst = 0.0;
+    for (int j = N; j >= 0; j--)
+    {
+        double x = cos(SGPPI * j / N);
+        sgp4(rec, (mid + half * x - epoch_unix) / 60.0, ro, vo);
+        if (rec->error != 0)
+            return false;
+        double dx = cheb_eval(coef[0], x) - ro[0];
+        double dy = cheb_eval(coef[1], x) - ro[1];
+        double dz = cheb_eval(coef[2], x) - ro[2];
+        double d = sqrt(dx * dx + dy * dy + dz * dz);
+        if (d > worst)
+            worst = d;
+    }
+    *err_km = (float)worst;
+    return true;
+}
+
+/* copies the scratch window in under the seqlock */
+static void ephemeris_publish(EphemerisWindow *w, const EphemerisWindow *src)
+{
+    unsigned int seq = w->seq;
+    w->seq = seq + 1;
+    __sync_synchronize();
+    w->valid = src->valid;
+    w->t_start = src->t_start;
+    w->seg_len = src->seg_len;
+    w->num_segments = src->num_segments;
+    w->tolerance_km = src->tolerance_km;
+    w->fit_error_km = src->fit_error_km;
+    memcpy(w->coef, src->coef, sizeof(w->coef));
+    __sync_synchronize();
+    w->seq = seq + 2;
+}
+
+static bool ephemeris_stale(const EphemerisWindow *w, double now, float tolerance_km)
+{
+    if (!w || w->tolerance_km != tolerance_km || w->num_segments <= 0)
+        return true;
+    if (!w->valid) /* sgp4 refused last time; don't hammer it again until the clock moves a segment */
+        return fabs(now - w->t_start) >= w->seg_len;
+
+    /* refit once less than half the window is left ahead of the clock */
+    double span = w->seg_len * w->num_segments;
+    return now < w->t_start || now > w->t_start + 0.5 * span;
+}
+
+/* refits one sat's window around now. slides the existing segments along when it can and only fits the
+   new tail; a full refit halves the segment length until every segment is inside the tolerance, and
+   tries twice as long again next time if the last fit had tons of headroom */
+static void ephemeris_build(Satellite *sat, double now, float tolerance_km)
+{
+    EphemerisWindow *w = sat->ephem;
+    if (!w)
+    {
+        w = calloc(1, sizeof(EphemerisWindow));
+        if (!w)
+            return;
+        __sync_synchronize();
+        sat->ephem = w;
+    }
+
+    /* private copy of the load-time record. the live one is being written by whoever propagates this sat
+       right now, deep-space integrator state included, so it can't even be read safely from here */
+    struct elsetrec rec = sat->satrec_tle;
+    rec.atime = 0.0;
+
+    /* segment length: a quarter orbit to start with, then whatever the last fit settled on, doubled if it
+       had tons of headroom */
+    double period = 2.0 * SGPPI / sat->mean_motion;
+    bool reuse = w->valid && w->tolerance_km == tolerance_km;
+    double seg_len = period / 4.0;
+    if (reuse)
+        seg_len = (w->fit_error_km < tolerance_km / 50.0f) ? w->seg_len * 2.0 : w->seg_len;
+    if (seg_len > period / 2.0)
+        seg_len = period / 2.0;
+    if (seg_len > EPHEM_MAX_SEG_LEN)
+        seg_len = EPHEM_MAX_SEG_LEN;
+    if (seg_len < EPHEM_MIN_SEG_LEN)
+        seg_len = EPHEM_MIN_SEG_LEN;
+
+    EphemerisWindow *s = &ephem_scratch;
+    s->tolerance_km = tolerance_km;
+    s->num_segments = EPHEM_MAX_SEGMENTS;
+
+    if (reuse && seg_len == w->seg_len && now >= w->t_start)
+    {
+        int shift = (int)((now - w->t_start) / w->seg_len) - 1;
+        if (shift >= 1 && shift < w->num_segments)
+        {
+            int keep = w->num_segments - shift;
+            bool ok = true;
+            s->seg_len = w->seg_len;
+            s->t_start = w->t_start + shift * w->seg_len;
+            s->fit_error_km = w->fit_error_km;
+            memcpy(s->coef, w->coef[shift], keep * sizeof(s->coef[0]));
+            for (int k = keep; k < s->num_segments && ok; k++)
+            {
+                float err = 0.0f;
+                ok = ephemeris_fit_segment(&rec, sat->epoch_unix, s->t_start + k * s->seg_len, s->seg_len, s->coef[k], &err) &&
+                     err <= tolerance_km;
+                if (err > s->fit_error_km)
+                    s->fit_error_km = err;
+            }
+            if (ok)
+            {
+                s->valid = true;
+                ephemeris_publish(w, s);
+                return;
+            }
+            rec.atime = 0.0;
+        }
+    }
+
+    s->valid = false;
+    for (int attempt = 0; attempt < EPHEM_MAX_HALVINGS && !s->valid; attempt++)
+    {
+        bool ok = true;
+        bool sgp4_ok = true;
+        s->seg_len = seg_len;
+        s->t_start = now - seg_len; /* one segment of slack behind the clock for small backwards scrubs */
+        s->fit_error_km = 0.0f;
+        for (int k = 0; k < s->num_segments && ok; k++)
+        {
+            float err = 0.0f;
+            sgp4_ok = ephemeris_fit_segment(&rec, sat->epoch_unix, s->t_start + k * seg_len, seg_len, s->coef[k], &err);
+            ok = sgp4_ok && err <= tolerance_km;
+            if (err > s->fit_error_km)
+                s->fit_error_km = err;
+        }
+        if (!sgp4_ok)
+            break;
+        s->valid = ok;
+        rec.atime = 0.0;
+        seg_len *= 0.5;
+        if (seg_len < EPHEM_MIN_SEG_LEN)
+            break;
+    }
+
+    if (!s->valid)
+    {
+        /* leave a marker so ephemeris_stale backs off for a segment */
+        s->t_start = now;
+        s->num_segments = 1;
+    }
+    ephemeris_publish(w, s);
+}
+
+static void ephemeris_update_stats(int n)
+{
+    int windows = 0;
+    float worst = 0.0f;
+    for (int i = 0; i < n; i++)
+    {
+        EphemerisWindow *w = satellites[i]->ephem;
+        if (!sat_active[i] || !w || !w->valid)
+            continue;
+        windows++;
+        if (w->fit_error_km > worst)
+            worst = w->fit_error_km;
+    }
+    prop_stats.ephem_windows = windows;
+    prop_stats.ephem_max_error_km = worst;
+}
+
+static void ephemeris_builder_main(void *arg)
+{
+    (void)arg;
+    int cursor = 0;
+    int idle_run = 0; /* sats looked at since the last refit */
+
+    while (!ephem_quit)
+    {
+        float tolerance_km = ephem_tolerance_km;
+        if (tolerance_km <= 0.0f)
+        {
+            prop_stats.ephem_windows = 0;
+            WorkerSleepMs(50);
+            continue;
+        }
+
+        int built = 0;
+        bool wrapped = false;
+        catalog_lock();
+        int n = sat_count;
+        double now = ephem_clock_unix;
+        for (int k = 0; k < EPHEM_BUILDER_BATCH && k < n; k++)
+        {
+            if (cursor >= n)
+            {
+                cursor = 0;
+                wrapped = true;
+            }
+            int idx = cursor++;
+            if (!sat_active[idx] || !ephemeris_stale(satellites[idx]->ephem, now, tolerance_km))
+                continue;
+            ephemeris_build(satellites[idx], now, tolerance_km);
+            built++;
+        }
+        if (wrapped || n == 0)
+            ephemeris_update_stats(n);
+        catalog_unlock();
+
+        idle_run = built ? 0 : idle_run + EPHEM_BUILDER_BATCH;
+        if (n == 0 || idle_run >= n)
+        {
+            idle_run = 0;
+            WorkerSleepMs(5); /* everything's fresh, check back in a bit */
+        }
+    }
+}
+
+/* builder runs until stop_ephemeris_builder; the clock and tolerance are pushed in every frame */
+void start_ephemeris_builder(void)
+{
+    if (ephem_thread)
+        return;
+    if (!catalog_mutex)
+        catalog_mutex = WorkerMutexCreate();
+    ephem_quit = false;
+    ephem_thread = WorkerSpawn(ephemeris_builder_main, NULL);
+    if (!ephem_thread)
+        printf("Failed to start ephemeris builder, sticking with plain SGP4.\n");
+}
+
+void stop_ephemeris_builder(void)
+{
+    if (!ephem_thread)
+        return;
+    ephem_quit = true;
+    WorkerJoin(ephem_thread);
+    ephem_thread = NULL;
+}
+
+void update_ephemeris_clock(double current_unix, float tolerance_km)
+{
+    ephem_clock_unix = current_unix;
+    ephem_tolerance_km = ephem_thread ? tolerance_km : 0.0f;
+}
+
+/* full sgp4 state: TEME position (km) and velocity (km/s), unswizzled and in double */
+void calculate_state_vector(Satellite *sat, double current_unix, double r[3], double v[3])
+{
+    double tsince = (current_unix - sat->epoch_unix) / 60.0;
+
+    if (sat->satrec.method == 'd')
+        deep_space_seek(&sat->satrec, &sat->ds_checkpoints, tsince);
+    sgp4(&sat->satrec, tsince, r, v);
+}
+
+/* main sgp4 crank; outputs raw ECI coordinates */
+/* precalculated unix time passed down to prevent excessyear/day conversions */
+Vector3 calculate_position(Satellite *sat, double current_unix)
+{
+    Vector3 pos;
+    if (ephemeris_position(sat, current_unix, &pos))
+        return pos;
+
+    double ro[3] = {0};
+    double vo[3] = {0};
+    calculate_state_vector(sat, current_unix, ro, vo);
+
+    pos.x = (float)(ro[0]);
+    pos.y = (float)(ro[2]);
+    pos.z = (float)(-ro[1]);
+
+    return pos;
+}
+
+/* batched propagation: the catalog gets partitioned at load into near-earth and deep-space groups.
+   near-earth sgp4 coefficients get copied out of the fat elsetrec structs into flat per-field
+   arrays, so the hot crank walks contiguous memory with no method branch. each block of lanes is
+   gathered into fixed size arrays and run through loops with no libm calls and no branches, which the
+   compiler turns into SIMD: SSE2 or AVX2 (picked at load time, see SGP4_BATCH_CLONES) on x86-64, NEON on
+   arm64. deep-space sats (dspace/dpper) get their own scalar routine. */
+#define SGP4_BATCH_BLOCK 64
+
+/* gcc on linux builds the block routine twice and picks the avx2 one at load time on cpus that have it.
+   elsewhere it's whatever the target's baseline vector unit is */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define SGP4_BATCH_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define SGP4_BATCH_CLONES
+#endif
+
+/* every near-earth coefficient the batch loop reads, copied by name from the elsetrec */
+#define SGP4_SOA_FIELDS(X) \
+    X(mo) X(mdot) X(argpo) X(argpdot) X(nodeo) X(nodedot) X(nodecf) \
+    X(cc1) X(cc4) X(cc5) X(bstar) X(d2) X(d3) X(d4) X(delmo) X(eta) \
+    X(omgcof) X(xmcof) X(sinmao) X(t2cof) X(t3cof) X(t4cof) X(t5cof) \
+    X(no_unkozai) X(ecco) X(inclo) X(aycof) X(xlcof) X(con41) X(x1mth2) \
+    X(x7thm1) X(j2) X(xke) X(radiusearthkm)
+
+typedef struct
+{
+    int count;
+    int capacity;
+    int *sat_idx;
+    double *epoch_unix;
+    double *am0;   /* (xke / no)^(2/3), constant per object */
+    double *sinio;
+    double *cosio;
+#define X(f) double *f;
+    SGP4_SOA_FIELDS(X)
+#undef X
+} NearEarthSoA;
+
+static NearEarthSoA near_soa = {0};
+static int *deep_sats = NULL;           /* satellite indices of the deep-space partition */
+static int deep_count = 0;
+static int deep_capacity = 0;
+static unsigned int batch_generation = 0;
+
+PropagationStats prop_stats = {0};
+
+static void near_soa_reserve(int capacity)
+{
+    if (capacity <= near_soa.capacity) return;
+    near_soa.sat_idx = realloc(near_soa.sat_idx, capacity * sizeof(int));
+    near_soa.epoch_unix = realloc(near_soa.epoch_unix, capacity * sizeof(double));
+    near_soa.am0 = realloc(near_soa.am0, capacity * sizeof(double));
+    near_soa.sinio = realloc(near_soa.sinio, capacity * sizeof(double));
+    near_soa.cosio = realloc(near_soa.cosio, capacity * sizeof(double));
+#define X(f) near_soa.f = realloc(near_soa.f, capacity * sizeof(double));
+    SGP4_SOA_FIELDS(X)
+#undef X
+    near_soa.capacity = capacity;
+}
+
+/* splits the catalog into the two partitions if it changed since the last call; main thread only */
+void prepare_batch_propagation(void)
+{
+    if (batch_generation == catalog_generation) return;
+    batch_generation = catalog_generation;
+
+    if (sat_count > deep_capacity)
+    {
+        deep_capacity = sat_count;
+        deep_sats = realloc(deep_sats, deep_capacity * sizeof(int));
+    }
+    near_soa_reserve(sat_count > 0 ? sat_count : 1);
+    near_soa.count = 0;
+    deep_count = 0;
+
+    for (int i = 0; i < sat_count; i++)
+    {
+        struct elsetrec *rec = &satellites[i]->satrec;
+        if (rec->method == 'd')
+        {
+            deep_sats[deep_count++] = i;
+            continue;
+        }
+
+        int l = near_soa.count++;
+        near_soa.sat_idx[l] = i;
+        near_soa.epoch_unix[l] = satellites[i]->epoch_unix;
+#define X(f) near_soa.f[l] = rec->f;
+        SGP4_SOA_FIELDS(X)
+#undef X
+        near_soa.am0[l] = pow(rec->xke / rec->no_unkozai, 2.0 / 3.0);
+        near_soa.sinio[l] = sin(rec->inclo);
+        near_soa.cosio[l] = cos(rec->inclo);
+
+        /* simplified drag model skips these terms entirely, zeroing them makes the math identical without a branch */
+        if (rec->isimp == 1)
+        {
+            near_soa.omgcof[l] = near_soa.xmcof[l] = 0.0;
+            near_soa.d2[l] = near_soa.d3[l] = near_soa.d4[l] = 0.0;
+            near_soa.cc5[l] = 0.0;
+            near_soa.t3cof[l] = near_soa.t4cof[l] = near_soa.t5cof[l] = 0.0;
+        }
+    }
+
+    prop_stats.near_count = near_soa.count;
+    prop_stats.deep_count = deep_count;
+}
+
+int get_near_earth_count(void)
+{
+    return near_soa.count;
+}
+
+int get_deep_space_count(void)
+{
+    return deep_count;
+}
+
+/* 1.5 * 2^52: adding it to a double under 2^51 in magnitude rounds it to the nearest integer, which lands in
+   the low mantissa bits. the branch-free stand-in for rint/lround in the block loops */
+#define BATCH_ROUND_MAGIC 6755399441055744.0
+
+/* pi/2 in pieces of 24 bits (the last one rounded), so k * piece is exact for |k| < 2^29: drag can run the
+   mean anomaly into the millions of radians a few years out, and that still reduces cleanly */
+#define BATCH_PIO2_1 1.570796251296997070312e+00
+#define BATCH_PIO2_2 7.549789415861596353352e-08
+#define BATCH_PIO2_3 5.390302529957764765545e-15
+#define BATCH_PIO2_4 3.282003542873500474440e-22
+
+/* x minus the nearest multiple of pi/2, and which quadrant that was (low two bits) */
+static inline double batch_reduce_pio2(double x, uint64_t *quadrant)
+{
+    double k = x * 6.36619772367581382433e-01 + BATCH_ROUND_MAGIC;
+    memcpy(quadrant, &k, sizeof(k));
+    k -= BATCH_ROUND_MAGIC;
+    return (((x - k * BATCH_PIO2_1) - k * BATCH_PIO2_2) - k * BATCH_PIO2_3) - k * BATCH_PIO2_4;
+}
+
+/* sin and cos without libm, for the block loops: fdlibm's kernel polynomials on [-pi/4, pi/4] with the
+   quadrant applied through bit masks. within an ulp or two of libm for |x| < 8e8 rad */
+static inline void batch_sincos(double x, double *s, double *c)
+{
+    uint64_t q;
+    double r = batch_reduce_pio2(x, &q);
+    double z = r * r;
+
+    double ps = r + r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 +
+                z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+    double hz = 0.5 * z, w = 1.0 - hz;
+    double pc = w + (((1.0 - w) - hz) + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05 +
+                z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11))))));
+
+    /* odd quadrants swap sin and cos, sin flips sign in quadrants 2 and 3, cos in 1 and 2 */
+    uint64_t sb, cb, swap = 0 - (q & 1);
+    memcpy(&sb, &ps, sizeof(sb));
+    memcpy(&cb, &pc, sizeof(cb));
+    uint64_t sr = ((sb & ~swap) | (cb & swap)) ^ ((q & 2) << 62);
+    uint64_t cr = ((cb & ~swap) | (sb & swap)) ^ (((q + 1) & 2) << 62);
+    memcpy(s, &sr, sizeof(sr));
+    memcpy(c, &cr, sizeof(cr));
+}
+
+/* x moved into [-pi, pi]. stands in for sgp4's fmod(x, twopi), which lands in (-2pi, 2pi) instead: these
+   angles only ever go into sin/cos and kepler, where a whole turn makes no difference */
+static inline double batch_wrap_twopi(double x)
+{
+    double k = x * 1.59154943091895335769e-01 + BATCH_ROUND_MAGIC;
+    k -= BATCH_ROUND_MAGIC;
+    return (((x - k * (4.0 * BATCH_PIO2_1)) - k * (4.0 * BATCH_PIO2_2)) - k * (4.0 * BATCH_PIO2_3)) - k * (4.0 * BATCH_PIO2_4);
+}
+
+/* c ? a : b through a bit mask. a plain ?: ahead of the division in the secular loop gets turned back into
+   a branch (each side specialized on the value it picks), and a loop with a branch in it doesn't vectorize */
+static inline double batch_select(bool c, double a, double b)
+{
+    const uint64_t ones = ~(uint64_t)0;
+    double all;
+    memcpy(&all, &ones, sizeof(all));
+    double md = c ? all : 0.0;
+    uint64_t m, ab, bb;
+    memcpy(&m, &md, sizeof(m));
+    memcpy(&ab, &a, sizeof(ab));
+    memcpy(&bb, &b, sizeof(bb));
+    uint64_t r = (ab & m) | (bb & ~m);
+    double out;
+    memcpy(&out, &r, sizeof(out));
+    return out;
+}
+
+/* one block's worth of soa lanes, gathered so the loops below read contiguous memory */
+typedef struct
+{
+    double epoch_unix[SGP4_BATCH_BLOCK];
+    double am0[SGP4_BATCH_BLOCK];
+    double sinio[SGP4_BATCH_BLOCK];
+    double cosio[SGP4_BATCH_BLOCK];
+#define X(f) double f[SGP4_BATCH_BLOCK];
+    SGP4_SOA_FIELDS(X)
+#undef X
+} NearEarthBlock;
+
+/* straight port of the near-earth half of sgp4() (position only) over a block of soa lanes. the math runs
+   over all SGP4_BATCH_BLOCK lanes every time, the ones past n just repeat lane 0, so every loop has a fixed
+   trip count and no remainder. sets the same satrec.error codes sgp4() would (1 eccentricity, 4 semi-latus
+   rectum, 6 decayed) and, like it, still writes whatever position falls out */
+SGP4_BATCH_CLONES
+static void propagate_near_earth_block(const int *lanes, int n, double current_unix)
+{
+    NearEarthBlock b;
+    double u[SGP4_BATCH_BLOCK], eo1[SGP4_BATCH_BLOCK], sineo1[SGP4_BATCH_BLOCK], coseo1[SGP4_BATCH_BLOCK];
+    double axnl[SGP4_BATCH_BLOCK], aynl[SGP4_BATCH_BLOCK], am[SGP4_BATCH_BLOCK], nodem[SGP4_BATCH_BLOCK], ecc[SGP4_BATCH_BLOCK];
+    double pl[SGP4_BATCH_BLOCK], mrt[SGP4_BATCH_BLOCK], px[SGP4_BATCH_BLOCK], py[SGP4_BATCH_BLOCK], pz[SGP4_BATCH_BLOCK];
+
+    for (int i = 0; i < SGP4_BATCH_BLOCK; i++)
+    {
+        int l = lanes[i < n ? i : 0];
+        b.epoch_unix[i] = near_soa.epoch_unix[l];
+        b.am0[i] = near_soa.am0[l];
+        b.sinio[i] = near_soa.sinio[l];
+        b.cosio[i] = near_soa.cosio[l];
+#define X(f) b.f[i] = near_soa.f[l];
+        SGP4_SOA_FIELDS(X)
+#undef X
+    }
+
+    /* secular gravity, drag and long period periodics */
+    for (int i = 0; i < SGP4_BATCH_BLOCK; i++)
+    {
+        double t = (current_unix - b.epoch_unix[i]) / 60.0;
+        double t2 = t * t, t3 = t2 * t, t4 = t3 * t;
+
+        double xmdf = b.mo[i] + b.mdot[i] * t;
+        double argpdf = b.argpo[i] + b.argpdot[i] * t;
+        double nodm = b.nodeo[i] + b.nodedot[i] * t + b.nodecf[i] * t2;
+
+        double sin_xmdf, cos_xmdf;
+        batch_sincos(xmdf, &sin_xmdf, &cos_xmdf);
+        double delomg = b.omgcof[i] * t;
+        double delmtemp = 1.0 + b.eta[i] * cos_xmdf;
+        double delm = b.xmcof[i] * (delmtemp * delmtemp * delmtemp - b.delmo[i]);
+        double mm = xmdf + delomg + delm;
+        double argpm = argpdf - delomg - delm;
+
+        double sin_mm, cos_mm;
+        batch_sincos(mm, &sin_mm, &cos_mm);
+        double tempa = 1.0 - b.cc1[i] * t - b.d2[i] * t2 - b.d3[i] * t3 - b.d4[i] * t4;
+        double tempe = b.bstar[i] * b.cc4[i] * t + b.bstar[i] * b.cc5[i] * (sin_mm - b.sinmao[i]);
+        double templ = b.t2cof[i] * t2 + b.t3cof[i] * t3 + t4 * (b.t4cof[i] + t * b.t5cof[i]);
+
+        double a = b.am0[i] * tempa * tempa;
+        double em = b.ecco[i] - tempe;
+        ecc[i] = em;
+        em = batch_select(em < 1.0e-6, 1.0e-6, em);
+        mm = mm + b.no_unkozai[i] * templ;
+        nodm = batch_wrap_twopi(nodm);
+        argpm = batch_wrap_twopi(argpm);
+
+        double sin_argpm, cos_argpm;
+        batch_sincos(argpm, &sin_argpm, &cos_argpm);
+        double ax = em * cos_argpm;
+        double temp = 1.0 / (a * (1.0 - em * em));
+        double ay = em * sin_argpm + temp * b.aycof[i];
+        double xl = mm + argpm + nodm + temp * b.xlcof[i] * ax;
+
+        u[i] = batch_wrap_twopi(xl - nodm);
+        eo1[i] = u[i];
+        axnl[i] = ax;
+        aynl[i] = ay;
+        am[i] = a;
+        nodem[i] = nodm;
+    }
+
+    /* kepler; every lane takes the same number of newton steps, converged lanes just add ~0 */
+    for (int ktr = 0; ktr < 10; ktr++)
+    {
+        double step[SGP4_BATCH_BLOCK];
+        for (int i = 0; i < SGP4_BATCH_BLOCK; i++)
+        {
+            double s, c;
+            batch_sincos(eo1[i], &s, &c);
+            double tem5 = (u[i] - aynl[i] * c + axnl[i] * s - eo1[i]) / (1.0 - c * axnl[i] - s * aynl[i]);
+            tem5 = tem5 > 0.95 ? 0.95 : tem5;
+            tem5 = tem5 < -0.95 ? -0.95 : tem5;
+            eo1[i] += tem5;
+            sineo1[i] = s;
+            coseo1[i] = c;
+            step[i] = tem5;
+        }
+        int i = 0;
+        while (i < SGP4_BATCH_BLOCK && fabs(step[i]) < 1.0e-12)
+            i++;
+        if (i == SGP4_BATCH_BLOCK)
+            break;
+    }
+
+    /* short period periodics and orientation. lanes with pl < 0 turn into NaNs here, the store loop below
+       puts them at the origin instead */
+    for (int i = 0; i < SGP4_BATCH_BLOCK; i++)
+    {
+        double ecose = axnl[i] * coseo1[i] + aynl[i] * sineo1[i];
+        double esine = axnl[i] * sineo1[i] - aynl[i] * coseo1[i];
+        double el2 = axnl[i] * axnl[i] + aynl[i] * aynl[i];
+        pl[i] = am[i] * (1.0 - el2);
+
+        double rl = am[i] * (1.0 - ecose);
+        double betal = sqrt(1.0 - el2);
+        double temp = esine / (1.0 + betal);
+        double sinu = am[i] / rl * (sineo1[i] - aynl[i] - axnl[i] * temp);
+        double cosu = am[i] / rl * (coseo1[i] - axnl[i] + aynl[i] * temp);
+        double sin2u = (cosu + cosu) * sinu;
+        double cos2u = 1.0 - 2.0 * sinu * sinu;
+        double temp1 = 0.5 * b.j2[i] / pl[i];
+        double temp2 = temp1 / pl[i];
+
+        mrt[i] = rl * (1.0 - 1.5 * temp2 * betal * b.con41[i]) + 0.5 * temp1 * b.x1mth2[i] * cos2u;
+        double xnode = nodem[i] + 1.5 * temp2 * b.cosio[i] * sin2u;
+        double xinc = b.inclo[i] + 1.5 * temp2 * b.cosio[i] * b.sinio[i] * cos2u;
+
+        /* sgp4 takes su = atan2(sinu, cosu) and then sin/cos of su minus a small correction. the angle
+           addition formula gets there without the atan2 */
+        double norm = 1.0 / sqrt(sinu * sinu + cosu * cosu);
+        double sin_du, cos_du;
+        batch_sincos(0.25 * temp2 * b.x7thm1[i] * sin2u, &sin_du, &cos_du);
+        double sinsu = (sinu * cos_du - cosu * sin_du) * norm;
+        double cossu = (cosu * cos_du + sinu * sin_du) * norm;
+
+        double snod, cnod, sini, cosi;
+        batch_sincos(xnode, &snod, &cnod);
+        batch_sincos(xinc, &sini, &cosi);
+        double xmx = -snod * cosi;
+        double xmy = cnod * cosi;
+        double r = mrt[i] * b.radiusearthkm[i];
+
+        /* same axis swizzle as calculate_position */
+        px[i] = r * (xmx * sinsu + cnod * cossu);
+        py[i] = r * (sini * sinsu);
+        pz[i] = -r * (xmy * sinsu + snod * cossu);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        int idx = near_soa.sat_idx[lanes[i]];
+        struct elsetrec *rec = &satellites[idx]->satrec;
+        if (pl[i] < 0.0)
+        {
+            /* same as sgp4(): bogus elements come out at the origin and get culled by the caller */
+            rec->error = 4;
+            sat_current_pos[idx] = (Vector3){0.0f, 0.0f, 0.0f};
+            continue;
+        }
+        rec->error = mrt[i] < 1.0 ? 6 : (ecc[i] >= 1.0 || ecc[i] < -0.001) ? 1 : 0;
+        sat_current_pos[idx] = (Vector3){(float)px[i], (float)py[i], (float)pz[i]};
+    }
+}
+
+/* near-earth partition: updates sat_current_pos for active lanes [start, end); call prepare_batch_propagation first */
+void propagate_near_earth(double current_unix, int start, int end)
+{
+    int lanes[SGP4_BATCH_BLOCK];
+    int n = 0;
+
+    if (end > near_soa.count) end = near_soa.count;
+    for (int l = start; l < end; l++)
+    {
+        int idx = near_soa.sat_idx[l];
+        if (!sat_active[idx] || ephemeris_position(satellites[idx], current_unix, &sat_current_pos[idx]))
+            continue;
+        lanes[n] = l;
+        if (++n == SGP4_BATCH_BLOCK)
+        {
+            propagate_near_earth_block(lanes, n, current_unix);
+            n = 0;
+        }
+    }
+    if (n > 0)
+        propagate_near_earth_block(lanes, n, current_unix);
+}
+
+int get_deep_space_active_count(void)
+{
+    int n = 0;
+    for (int k = 0; k < deep_count; k++)
+        n += sat_active[deep_sats[k]];
+    return n;
+}
+
+/* deep-space partition: resonance integrator and lunisolar terms, one sat at a time through sgp4() */
+void propagate_deep_space(double current_unix, int start, int end)
+{
+    if (end > deep_count) end = deep_count;
+    for (int k = start; k < end; k++)
+    {
+        int idx = deep_sats[k];
+        if (sat_active[idx])
+            sat_current_pos[idx] = calculate_position(satellites[idx], current_unix);
+    }
+}
+
+/* projects 3D orbital space onto a 2D equirectangular map plane */
+void get_map_coordinates(Vector3 pos, double gmst_deg, float earth_offset, float map_w, float map_h, float *out_x, float *out_y)
+{
+    float r = Vector3Length(pos);
+    if (r == 0)
+        r = 0.0001f;
+    float phi = acosf(pos.y / r);
+    float v = phi / PI;
+
+    float theta_sat = atan2f(-pos.z, pos.x);
+    float R_rad = (gmst_deg + earth_offset) * DEG2RAD;
+    float theta_tex = theta_sat - R_rad;
+
+    while (theta_tex > PI)
+        theta_tex -= 2.0f * PI;
+    while (theta_tex < -PI)
+        theta_tex += 2.0f * PI;
+
+    float u = theta_tex / (2.0f * PI) + 0.5f;
+    *out_x = (u - 0.5f) * map_w;
+    *out_y = (v - 0.5f) * map_h;
+}
+
+/* finds where the sat hits the high and low points of its orbit in 2D */
+void get_apsis_2d(Satellite *sat, double current_time, bool is_apoapsis, double gmst_deg, float earth_offset, float map_w, float map_h, Vector2 *out)
+{
+    (void)gmst_deg;
+
+    double current_unix = get_unix_from_epoch(current_time);
+    double delta_time_s = current_unix - sat->epoch_unix;
+
+    double M = fmod(sat->mean_anomaly + sat->mean_motion * delta_time_s, 2.0 * PI);
+    if (M < 0)
+        M += 2.0 * PI;
+
+    double target_M = is_apoapsis ? PI : 0.0;
+    double diff = target_M - M;
+    if (diff < 0)
+        diff += 2.0 * PI;
+
+    double t_target = current_time + (diff / sat->mean_motion) / 86400.0;
+    double t_target_unix = get_unix_from_epoch(t_target);
+    Vector3 pos3d = calculate_position(sat, t_target_unix);
+    double gmst_target = epoch_to_gmst(t_target);
+
+    get_map_coordinates(pos3d, gmst_target, earth_offset, map_w, map_h, &out->x, &out->y);
+}
+
+/* predicts the timestamps for the next perigee and apoapsis */
+void get_apsis_times(Satellite *sat, double current_time, double *out_peri_unix, double *out_apo_unix)
+{
+    double current_unix = get_unix_from_epoch(current_time);
+    double delta_time_s = current_unix - sat->epoch_unix;
+
+    double M = fmod(sat->mean_anomaly + sat->mean_motion * delta_time_s, 2.0 * PI);
+    if (M < 0)
+        M += 2.0 * PI;
+
+    double diff_peri = 0.0 - M;
+    if (diff_peri < 0)
+        diff_peri += 2.0 * PI;
+    double diff_apo = PI - M;
+    if (diff_apo < 0)
+        diff_apo += 2.0 * PI;
+
+    double t_peri = current_time + (diff_peri / sat->mean_motion) / 86400.0;
+    double t_apo = current_time + (diff_apo / sat->mean_motion) / 86400.0;
+
+    *out_peri_unix = get_unix_from_epoch(t_peri);
+    *out_apo_unix = get_unix_from_epoch(t_apo);
+}
+
+/* Calculates cache resolution based on orbital eccentricity */
+int calculate_orbit_cache_resolution(double eccentricity, int active_sat_count, int total_sat_count)
+{
+    (void)active_sat_count;  // unused
+    (void)total_sat_count;   // unused
+    
+    // Low eccentricity
+    if (eccentricity < 0.05)
+        return 180;
+    // Moderate eccentricity
+    if (eccentricity < 0.3)
+        return 270;
+    // High eccentricity
+    return ORBIT_CACHE_SIZE;
+}
+
+/* orbit caches get built on their own thread. once per rendered frame it picks out the stale rings of
+   orbits that were drawn recently and, highest priority first, copies each one into a spare buffer,
+   propagates only the grid steps that came into view at the head and swaps the result into
+   sat->orbit_cache, so the renderer only ever sees whole rings.
+   a swapped-out ring sits in the retired list for a couple of frames before anything reuses it, in case a
+   draw was still walking it. the pool itself (LRU, byte count, retired and spare buffers) belongs to the
+   builder, or to whoever else holds the catalog lock */
+#define ORBIT_WANT_FRAMES 120          /* drawn within this many frames = still wanted */
+#define ORBIT_CACHE_IDLE_FRAMES 600    /* not drawn for this long = handed back even under budget */
+#define ORBIT_BUILDER_BATCH 16
+#define ORBIT_SPARE_MAX 64             /* swapped-out buffers kept around for reuse */
+
+static WorkerThread *orbit_thread = NULL;
+static volatile bool orbit_quit = false;
+static volatile double orbit_clock_unix = 0.0;
+static volatile unsigned int orbit_frame = 1;
+static volatile size_t orbit_pool_budget = 64u * 1024u * 1024u;
+static volatile float orbit_frame_budget_ms = 8.0f;
+static volatile size_t orbit_pool_bytes = 0; /* published rings + spares */
+
+static Satellite *orbit_lru_head = NULL;
+static Satellite *orbit_lru_tail = NULL;
+static OrbitCache *orbit_retired_head = NULL; /* oldest first */
+static OrbitCache *orbit_retired_tail = NULL;
+static OrbitCache *orbit_spares = NULL;
+static int orbit_spare_count = 0;
+
+static size_t orbit_cache_bytes(int resolution)
+{
+    return sizeof(OrbitCache) + resolution * sizeof(Vector3);
+}
+
+static void orbit_lru_unlink(Satellite *sat)
+{
+    if (sat->orbit_lru_prev)
+        sat->orbit_lru_prev->orbit_lru_next = sat->orbit_lru_next;
+    else if (orbit_lru_head == sat)
+        orbit_lru_head = sat->orbit_lru_next;
+    if (sat->orbit_lru_next)
+        sat->orbit_lru_next->orbit_lru_prev = sat->orbit_lru_prev;
+    else if (orbit_lru_tail == sat)
+        orbit_lru_tail = sat->orbit_lru_prev;
+    sat->orbit_lru_prev = sat->orbit_lru_next = NULL;
+}
+
+static void orbit_lru_push_front(Satellite *sat)
+{
+    sat->orbit_lru_prev = NULL;
+    sat->orbit_lru_next = orbit_lru_head;
+    if (orbit_lru_head)
+        orbit_lru_head->orbit_lru_prev = sat;
+    orbit_lru_head = sat;
+    if (!orbit_lru_tail)
+        orbit_lru_tail = sat;
+}
+
+/* retired rings stop counting against the budget straight away, they're on their way out */
+static void orbit_cache_retire(OrbitCache *c)
+{
+    orbit_pool_bytes -= orbit_cache_bytes(c->resolution);
+    c->retired_frame = orbit_frame;
+    c->retired_next = NULL;
+    if (orbit_retired_tail)
+        orbit_retired_tail->retired_next = c;
+    else
+        orbit_retired_head = c;
+    orbit_retired_tail = c;
+}
+
+/* a ring retired during frame F may still be drawn from until F ends, and our read of the frame counter
+   can lag the renderer by one, so two frames on it's definitely free */
+static void orbit_cache_reclaim(void)
+{
+    while (orbit_retired_head && orbit_frame - orbit_retired_head->retired_frame >= 2)
+    {
+        OrbitCache *c = orbit_retired_head;
+        orbit_retired_head = c->retired_next;
+        if (!orbit_retired_head)
+            orbit_retired_tail = NULL;
+
+        if (orbit_spare_count < ORBIT_SPARE_MAX)
+        {
+            c->retired_next = orbit_spares;
+            orbit_spares = c;
+            orbit_spare_count++;
+            orbit_pool_bytes += orbit_cache_bytes(c->resolution);
+        }
+        else
+        {
+            free(c);
+        }
+    }
+}
+
+static void orbit_spares_free_one(void)
+{
+    OrbitCache *c = orbit_spares;
+    orbit_spares = c->retired_next;
+    orbit_spare_count--;
+    orbit_pool_bytes -= orbit_cache_bytes(c->resolution);
+    free(c);
+}
+
+void release_orbit_cache(Satellite *sat)
+{
+    OrbitCache *c = sat->orbit_cache;
+    if (!c)
+        return;
+    orbit_lru_unlink(sat);
+    __atomic_store_n(&sat->orbit_cache, NULL, __ATOMIC_RELEASE);
+    orbit_cache_retire(c);
+}
+
+/* spares go first, then the least recently drawn orbits. anything drawn this frame or the last gets a
+   second chance at the front of the list instead; false if the pool is full of orbits that are on screen */
+static bool orbit_cache_make_room(size_t need)
+{
+    while (orbit_pool_bytes + need > orbit_pool_budget && orbit_spares)
+        orbit_spares_free_one();
+
+    Satellite *first_spared = NULL;
+    while (orbit_pool_bytes + need > orbit_pool_budget && orbit_lru_tail && orbit_lru_tail != first_spared)
+    {
+        Satellite *victim = orbit_lru_tail;
+        if (orbit_frame - victim->orbit_wanted_frame > 1)
+        {
+            release_orbit_cache(victim);
+            continue;
+        }
+        orbit_lru_unlink(victim);
+        orbit_lru_push_front(victim);
+        if (!first_spared)
+            first_spared = victim;
+    }
+    return orbit_pool_bytes + need <= orbit_pool_budget;
+}
+
+static OrbitCache *orbit_cache_alloc(int resolution)
+{
+    OrbitCache **link = &orbit_spares;
+    for (OrbitCache *c = orbit_spares; c; link = &c->retired_next, c = c->retired_next)
+    {
+        if (c->resolution == resolution)
+        {
+            *link = c->retired_next;
+            orbit_spare_count--;
+            return c;
+        }
+    }
+
+    size_t need = orbit_cache_bytes(resolution);
+    if (!orbit_cache_make_room(need))
+        return NULL;
+    OrbitCache *c = malloc(need);
+    if (!c)
+        return NULL;
+    c->resolution = resolution;
+    orbit_pool_bytes += need;
+    return c;
+}
+
+/* gives back caches nobody has drawn in a while, once per frame */
+static void orbit_cache_trim_idle(void)
+{
+    Satellite *sat = orbit_lru_head;
+    while (sat)
+    {
+        Satellite *next = sat->orbit_lru_next;
+        if (orbit_frame - sat->orbit_wanted_frame > ORBIT_CACHE_IDLE_FRAMES)
+            release_orbit_cache(sat);
+        sat = next;
+    }
+}
+
+static Vector3 orbit_cache_point(Satellite *sat, struct elsetrec *rec, double t_unix)
+{
+    Vector3 pos;
+    if (ephemeris_position(sat, t_unix, &pos))
+        return pos;
+
+    double ro[3] = {0};
+    double vo[3] = {0};
+    sgp4(rec, (t_unix - sat->epoch_unix) / 60.0, ro, vo);
+    return (Vector3){(float)(ro[0]), (float)(ro[2]), (float)(-ro[1])};
+}
+
+/* bakes the future orbital path into a vertex buffer so sgp4 isnt re-ran every frame.
+   points sit on a fixed time grid in a ring: moving the clock forward only propagates the grid steps
+   that came into view at the head, and they overwrite the slots that just expired at the tail.
+   returns how many points got propagated */
+static int orbit_cache_build(Satellite *sat, double current_unix)
+{
+    int res = calculate_orbit_cache_resolution(sat->eccentricity, 0, sat_count);
+    double step = (2.0 * SGPPI / sat->mean_motion) / (res - 1);
+    long long k_now = (long long)floor(current_unix / step);
+    long long k_end = k_now + res; /* one past the newest point */
+
+    /* the ring is current while its oldest point is the last grid step at or before now */
+    OrbitCache *old = sat->orbit_cache;
+    bool same_grid = old && old->resolution == res && old->step == step;
+    if (same_grid && old->k0 == k_now)
+        return 0;
+
+    /* off the LRU while making room, or it could end up evicting the very ring it's about to copy from */
+    if (old)
+        orbit_lru_unlink(sat);
+    OrbitCache *c = orbit_cache_alloc(res);
+    if (!c)
+    {
+        if (old)
+            orbit_lru_push_front(sat);
+        return 0;
+    }
+
+    /* still overlapping the old window: keep what's there, only fill past its end */
+    long long k_from = k_now;
+    if (same_grid && k_now > old->k0 && k_now < old->k0 + res)
+    {
+        memcpy(c->points, old->points, res * sizeof(Vector3));
+        k_from = old->k0 + res;
+    }
+
+    /* private copy of the load-time record, the live one is being written by the main thread right now */
+    struct elsetrec rec = sat->satrec_tle;
+    rec.atime = 0.0;
+    for (long long k = k_from; k < k_end; k++)
+        c->points[k % res] = Vector3Scale(orbit_cache_point(sat, &rec, k * step), 1.0f / DRAW_SCALE);
+    c->step = step;
+    c->k0 = k_now;
+
+    __atomic_store_n(&sat->orbit_cache, c, __ATOMIC_RELEASE);
+    if (old)
+        orbit_cache_retire(old);
+    orbit_lru_push_front(sat);
+    return (int)(k_end - k_from);
+}
+
+/* stale rings get rebuilt in priority order (whatever the renderer last said about them), spending at
+   most the frame budget per rendered frame. pool_full stops us from walking the whole LRU again for
+   every uncached orbit once it's clear nothing can be evicted */
+typedef struct
+{
+    int idx;
+    float priority;
+} OrbitCacheTask;
+
+static OrbitCacheTask *orbit_tasks = NULL; /* builder only */
+static int orbit_task_capacity = 0;
+
+static int compare_orbit_tasks(const void *a, const void *b)
+{
+    const OrbitCacheTask *t1 = (const OrbitCacheTask *)a;
+    const OrbitCacheTask *t2 = (const OrbitCacheTask *)b;
+    if (t1->priority != t2->priority)
+        return t1->priority > t2->priority ? -1 : 1;
+    return t1->idx - t2->idx;
+}
+
+static bool orbit_cache_stale(Satellite *sat, double current_unix)
+{
+    const OrbitCache *c = sat->orbit_cache;
+    return !c || (long long)floor(current_unix / c->step) != c->k0;
+}
+
+/* caller holds the catalog lock */
+static int orbit_cache_collect(double current_unix)
+{
+    orbit_cache_reclaim();
+    orbit_cache_trim_idle();
+
+    int n = sat_count;
+    if (orbit_task_capacity < n)
+    {
+        OrbitCacheTask *grown = realloc(orbit_tasks, n * sizeof(OrbitCacheTask));
+        if (!grown)
+            return 0;
+        orbit_tasks = grown;
+        orbit_task_capacity = n;
+    }
+
+    int count = 0;
+    for (int i = 0; i < n; i++)
+    {
+        Satellite *sat = satellites[i];
+        if (sat_active[i] && is_orbit_wanted(sat) && orbit_cache_stale(sat, current_unix))
+            orbit_tasks[count++] = (OrbitCacheTask){i, sat->orbit_priority};
+    }
+    qsort(orbit_tasks, count, sizeof(OrbitCacheTask), compare_orbit_tasks);
+    return count;
+}
+
+/* one frame's worth of rebuilding. stops early once the budget is gone, the renderer has moved on to the
+   next frame (priorities may have changed), or the catalog got swapped out from under the task list.
+   returns points propagated */
+static int orbit_cache_run_frame(unsigned int frame, bool interruptible)
+{
+    float budget_ms = orbit_frame_budget_ms;
+    double now = orbit_clock_unix;
+
+    /* only time spent actually working counts, not waiting on the catalog lock */
+    catalog_lock();
+    double start_ms = WorkerClockMs();
+    unsigned int generation = catalog_generation;
+    int count = orbit_cache_collect(now);
+    double spent_ms = WorkerClockMs() - start_ms;
+    catalog_unlock();
+
+    int points = 0;
+    bool pool_full = false;
+    int t = 0;
+    while (t < count)
+    {
+        catalog_lock();
+        if (catalog_generation != generation)
+        {
+            catalog_unlock();
+            break;
+        }
+        start_ms = WorkerClockMs();
+        for (int k = 0; k < ORBIT_BUILDER_BATCH && t < count; k++, t++)
+        {
+            Satellite *sat = satellites[orbit_tasks[t].idx];
+            if (pool_full && !sat->orbit_cache)
+                continue;
+            int built = orbit_cache_build(sat, now);
+            if (!built && !sat->orbit_cache)
+                pool_full = true;
+            points += built;
+        }
+        spent_ms += WorkerClockMs() - start_ms;
+        catalog_unlock();
+
+        if (budget_ms > 0.0f && spent_ms >= budget_ms)
+            break;
+        if (interruptible && orbit_frame != frame)
+            break;
+    }
+    prop_stats.orbit_backlog = count - t;
+    return points;
+}
+
+static void orbit_cache_builder_main(void *arg)
+{
+    (void)arg;
+    unsigned int last_frame = 0;
+
+    while (!orbit_quit)
+    {
+        unsigned int frame = orbit_frame;
+        if (frame == last_frame)
+        {
+            WorkerSleepMs(1); /* this frame's budget is spent, or there was nothing to do */
+            continue;
+        }
+        last_frame = frame;
+
+        int points = orbit_cache_run_frame(frame, true);
+        if (points)
+            __sync_fetch_and_add(&prop_stats.orbit_points, points);
+    }
+}
+
+void start_orbit_cache_builder(void)
+{
+    if (orbit_thread)
+        return;
+    if (!catalog_mutex)
+        catalog_mutex = WorkerMutexCreate();
+    orbit_quit = false;
+    orbit_thread = WorkerSpawn(orbit_cache_builder_main, NULL);
+    if (!orbit_thread)
+        printf("Failed to start orbit cache builder, building them on the main thread.\n");
+}
+
+void stop_orbit_cache_builder(void)
+{
+    if (!orbit_thread)
+        return;
+    orbit_quit = true;
+    WorkerJoin(orbit_thread);
+    orbit_thread = NULL;
+}
+
+/* called for every orbit on screen whether or not there's a cache yet, so the builder knows who to fill
+   and in what order (see ORBIT_PRIORITY_FOCUSED) */
+void mark_orbit_drawn(Satellite *sat, float priority)
+{
+    sat->orbit_priority = priority;
+    sat->orbit_wanted_frame = orbit_frame;
+}
+
+bool is_orbit_wanted(Satellite *sat)
+{
+    return sat->orbit_wanted_frame != 0 && orbit_frame - sat->orbit_wanted_frame <= ORBIT_WANT_FRAMES;
+}
+
+/* latest finished ring for sat, or NULL. stays valid until the end of the frame */
+const OrbitCache *get_orbit_cache(Satellite *sat)
+{
+    return __atomic_load_n(&sat->orbit_cache, __ATOMIC_ACQUIRE);
+}
+
+/* once per frame, before anything gets drawn: advance the frame counter and push the clock and budgets to
+   the builder. without a builder thread the frame's budget gets spent right here instead */
+void begin_orbit_cache_frame(double current_unix, int budget_mb, float frame_budget_ms)
+{
+    orbit_clock_unix = current_unix;
+    if (budget_mb > 0)
+        orbit_pool_budget = (size_t)budget_mb * 1024u * 1024u;
+    orbit_frame_budget_ms = frame_budget_ms;
+    unsigned int frame = __sync_add_and_fetch(&orbit_frame, 1);
+
+    if (!orbit_thread)
+        prop_stats.orbit_points += orbit_cache_run_frame(frame, false);
+}
+
+size_t get_orbit_cache_pool_bytes(void)
+{
+    return orbit_pool_bytes;
+}
+
+/* converts raw orbital data into azimuth/elevation for a specific ground station */
+void get_az_el(Vector3 eci_pos, double gmst_deg, float obs_lat, float obs_lon, float obs_alt, double *az, double *el)
+{
+    double theta = gmst_deg * DEG2RAD; /* assuming earth_rotation_offset handled befor */
+    get_az_el_rot(eci_pos, sin(theta), cos(theta), obs_lat, obs_lon, obs_alt, az, el);
+}
+
+/* same thing with the earth rotation already as sin/cos, so sweeps (see GmstSweep) skip the trig */
+void get_az_el_rot(Vector3 eci_pos, double sin_theta, double cos_theta, float obs_lat, float obs_lon, float obs_alt, double *az, double *el)
+{
+    ObserverFrame of;
+    observer_frame_init(&of, obs_lat, obs_lon, obs_alt);
+    observer_look(&of, eci_pos, sin_theta, cos_theta, az, el);
+}
+
+/* the observer's ECEF position and local east/north/up axes only depend on where they stand, so anything
+   looking at more than one sat or time should build this once and go through observer_look */
+void observer_frame_init(ObserverFrame *of, float lat, float lon, float alt)
+{
+    of->lat = lat;
+    of->lon = lon;
+    of->alt = alt;
+    geodetic_to_ecef(lat, lon, alt, &of->ecef[0], &of->ecef[1], &of->ecef[2]);
+
+    double slat = sin(lat * DEG2RAD), clat = cos(lat * DEG2RAD);
+    double slon = sin(lon * DEG2RAD), clon = cos(lon * DEG2RAD);
+    of->enu[0][0] = -slon;
+    of->enu[0][1] = clon;
+    of->enu[0][2] = 0.0;
+    of->enu[1][0] = -slat * clon;
+    of->enu[1][1] = -slat * slon;
+    of->enu[1][2] = clat;
+    of->enu[2][0] = clat * clon;
+    of->enu[2][1] = clat * slon;
+    of->enu[2][2] = slat;
+}
+
+/* home_location gets poked from all over the ui, so just rebuild whenever it doesn't match anymore */
+static ObserverFrame home_frame;
+static bool home_frame_valid = false;
+
+const ObserverFrame *get_home_frame(void)
+{
+    if (!home_frame_valid || home_frame.lat != home_location.lat || home_frame.lon != home_location.lon || home_frame.alt != home_location.alt)
+    {
+        observer_frame_init(&home_frame, home_location.lat, home_location.lon, home_location.alt);
+        home_frame_valid = true;
+    }
+    return &home_frame;
+}
+
+/* one rotation into ECEF, one matrix multiply into ENU */
+static inline void observer_look_one(const ObserverFrame *of, Vector3 eci_pos, double sin_theta, double cos_theta, double *az, double *el)
+{
+    if (eci_pos.x == 0 && eci_pos.y == 0 && eci_pos.z == 0)
+    {
+        *az = 0;
+        *el = -90;
+        return;
+    }
+
+    double dx = eci_pos.x * cos_theta - eci_pos.z * sin_theta - of->ecef[0];
+    double dy = -eci_pos.x * sin_theta - eci_pos.z * cos_theta - of->ecef[1];
+    double dz = eci_pos.y - of->ecef[2];
+
+    double east = of->enu[0][0] * dx + of->enu[0][1] * dy + of->enu[0][2] * dz;
+    double north = of->enu[1][0] * dx + of->enu[1][1] * dy + of->enu[1][2] * dz;
+    double up = of->enu[2][0] * dx + of->enu[2][1] * dy + of->enu[2][2] * dz;
+
+    *el = atan2(up, sqrt(east * east + north * north)) * RAD2DEG;
+    *az = atan2(east, north) * RAD2DEG;
+    if (*az < 0)
+        *az += 360.0;
+}
+
+void observer_look(const ObserverFrame *of, Vector3 eci_pos, double sin_theta, double cos_theta, double *az, double *el)
+{
+    observer_look_one(of, eci_pos, sin_theta, cos_theta, az, el);
+}
+
+/* count positions at the same earth rotation */
+void observer_look_batch(const ObserverFrame *of, const Vector3 *eci_pos, int count, double sin_theta, double cos_theta, double *az, double *el)
+{
+    ObserverFrame local = *of; /* so the stores into az/el can't make it reload the frame every time */
+    for (int i = 0; i < count; i++)
+        observer_look_one(&local, eci_pos[i], sin_theta, cos_theta, &az[i], &el[i]);
+}
+
+/* qsort callback to keep passes chronological. ties go by sat, observer and then LOS, so the order never depends on
+   how the search happened to get split up */
+int compare_passes(const void *a, const void *b)
+{
+    const SatPass *p1 = (const SatPass *)a;
+    const SatPass *p2 = (const SatPass *)b;
+    if (p1->aos_epoch < p2->aos_epoch)
+        return -1;
+    if (p1->aos_epoch > p2->aos_epoch)
+        return 1;
+    int id1 = p1->sat ? p1->sat->id : -1;
+    int id2 = p2->sat ? p2->sat->id : -1;
+    if (id1 != id2)
+        return id1 < id2 ? -1 : 1;
+    if (p1->observer != p2->observer)
+        return p1->observer < p2->observer ? -1 : 1;
+    if (p1->los_epoch < p2->los_epoch)
+        return -1;
+    if (p1->los_epoch > p2->los_epoch)
+        return 1;
+    return 0;
+}
+
+static int compare_pass_ptrs(const void *a, const void *b)
+{
+    return compare_passes(*(const SatPass *const *)a, *(const SatPass *const *)b);
+}
+
+static bool pass_list_push(PassList *list, const SatPass *p)
+{
+    if (list->count == list->capacity)
+    {
+        int new_capacity = list->capacity ? list->capacity * 2 : 8;
+        SatPass *grown = (SatPass *)realloc(list->items, new_capacity * sizeof(SatPass));
+        if (!grown)
+            return false;
+        list->items = grown;
+        list->capacity = new_capacity;
+    }
+    list->items[list->count++] = *p;
+    return true;
+}
+
+static void pass_list_free(PassList *list)
+{
+    free(list->items);
+    *list = (PassList){0};
+}
+
+static double pass_elevation(Satellite *sat, const ObserverFrame *of, double t)
+{
+    double az, el;
+    double theta = epoch_to_gmst(t) * DEG2RAD;
+    observer_look(of, calculate_position(sat, get_unix_from_epoch(t)), sin(theta), cos(theta), &az, &el);
+    return el;
+}
+
+/* one propagation, looked at from every observer */
+static void pass_elevations(Satellite *sat, const PassObserver *obs, int num_obs, double t, double sin_theta, double cos_theta, double *el)
+{
+    Vector3 pos = calculate_position(sat, get_unix_from_epoch(t));
+    for (int k = 0; k < num_obs; k++)
+    {
+        double az;
+        observer_look(&obs[k].frame, pos, sin_theta, cos_theta, &az, &el[k]);
+    }
+}
+
+/* elevation (deg) and its rate (deg/s) off one sgp4 call. same ECEF trick as get_sat_range_rate: rotate both
+   vectors, take the frame rotation out of the velocity, then differentiate sin(el) = up / range */
+static double pass_elevation_rate(Satellite *sat, const ObserverFrame *home, double t, double *rate)
+{
+    double theta = epoch_to_gmst(t) * DEG2RAD;
+    double cos_t = cos(theta);
+    double sin_t = sin(theta);
+
+    double r[3], v[3];
+    calculate_state_vector(sat, get_unix_from_epoch(t), r, v);
+
+    double s_x = r[0] * cos_t + r[1] * sin_t;
+    double s_y = -r[0] * sin_t + r[1] * cos_t;
+    double d[3] = {s_x - home->ecef[0], s_y - home->ecef[1], r[2] - home->ecef[2]};
+    double dv[3] = {v[0] * cos_t + v[1] * sin_t + EARTH_ROTATION_RATE * s_y, -v[0] * sin_t + v[1] * cos_t - EARTH_ROTATION_RATE * s_x, v[2]};
+
+    const double *up_dir = home->enu[2];
+    double range = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    double up = up_dir[0] * d[0] + up_dir[1] * d[1] + up_dir[2] * d[2];
+    double up_rate = up_dir[0] * dv[0] + up_dir[1] * dv[1] + up_dir[2] * dv[2];
+    double range_rate = (d[0] * dv[0] + d[1] * dv[1] + d[2] * dv[2]) / range;
+
+    double sin_el = up / range;
+    double el = asin(fmax(-1.0, fmin(1.0, sin_el)));
+    double sin_el_rate = (up_rate - sin_el * range_rate) / range;
+    *rate = sin_el_rate / fmax(cos(el), 1e-9) * RAD2DEG;
+    return el * RAD2DEG;
+}
+
+/* newton on the elevation rate finds the horizon crossing between t0 and t1 (el0, el1 on opposite sides)
+   in a handful of sgp4 calls. the bracket shrinks as it goes, and any step that would leave it or has no
+   slope to go on gets a plain bisection instead */
+#define PASS_CROSSING_TOL_S 0.01
+#define PASS_CULMINATION_TOL_S 0.1
+
+static double pass_find_crossing(Satellite *sat, const ObserverFrame *of, double t0, double el0, double t1, double el1)
+{
+    double below = (el0 < 0.0) ? t0 : t1;
+    double above = (el0 < 0.0) ? t1 : t0;
+    double t = t0 + (t1 - t0) * el0 / (el0 - el1); /* straight line between the samples to start */
+
+    for (int i = 0; i < 32; i++)
+    {
+        double rate;
+        double el = pass_elevation_rate(sat, of, t, &rate);
+        if (el < 0.0)
+            below = t;
+        else
+            above = t;
+
+        double lo = fmin(below, above), hi = fmax(below, above);
+        double next = t - el / rate / 86400.0;
+        if (!(next > lo && next < hi))
+            next = 0.5 * (lo + hi);
+        if (fabs(next - t) * 86400.0 < PASS_CROSSING_TOL_S || (hi - lo) * 86400.0 < PASS_CROSSING_TOL_S)
+            return next;
+        t = next;
+    }
+    return t;
+}
+
+/* culmination is where the elevation rate goes through zero, somewhere in [a, b]. secant steps on the rate
+   (same as fitting a parabola to the elevation) with the illinois tweak so a lopsided pass can't pin one
+   end of the bracket down forever */
+static void pass_find_culmination(Satellite *sat, const ObserverFrame *of, SatPass *p, double a, double b)
+{
+    double rate_a, rate_b;
+    double el_a = pass_elevation_rate(sat, of, a, &rate_a);
+    double el_b = pass_elevation_rate(sat, of, b, &rate_b);
+
+    /* already on the way down at a, or still climbing at b (window cut the pass off) */
+    if (rate_a <= 0.0 || rate_b >= 0.0)
+    {
+        bool at_a = (rate_a <= 0.0 && el_a >= el_b) || rate_b < 0.0;
+        p->max_el_epoch = at_a ? a : b;
+        p->max_el = (float)(at_a ? el_a : el_b);
+        return;
+    }
+
+    double t = a, el = el_a;
+    int kept = 0; /* which end survived the last step, -1 = a, 1 = b */
+    for (int i = 0; i < 32 && (b - a) * 86400.0 >= PASS_CULMINATION_TOL_S; i++)
+    {
+        t = b - rate_b * (b - a) / (rate_b - rate_a);
+        if (!(t > a && t < b))
+            t = 0.5 * (a + b);
+
+        double rate;
+        el = pass_elevation_rate(sat, of, t, &rate);
+        if (rate > 0.0)
+        {
+            a = t;
+            rate_a = rate;
+            if (kept == 1)
+                rate_b *= 0.5;
+            kept = 1;
+        }
+        else
+        {
+            b = t;
+            rate_b = rate;
+            if (kept == -1)
+                rate_a *= 0.5;
+            kept = -1;
+        }
+    }
+    p->max_el_epoch = t;
+    p->max_el = (float)el;
+}
+
+/* sky tracks only get made for passes somebody actually looks at in the polar plot. a few are kept around
+   so clicking back and forth through the list doesn't redo them, least recently used one gets reused */
+#define SKY_TRACK_CACHE 8
+static SkyTrack sky_tracks[SKY_TRACK_CACHE];
+static unsigned int sky_track_clock = 0;
+
+const SkyTrack *pass_sky_track(const SatPass *p)
+{
+    const ObserverFrame *of = (p->observer >= 0 && p->observer < num_pass_observers) ? &pass_observers[p->observer].frame : get_home_frame();
+    SkyTrack *st = &sky_tracks[0];
+    for (int i = 0; i < SKY_TRACK_CACHE; i++)
+    {
+        SkyTrack *c = &sky_tracks[i];
+        if (c->sat == p->sat && c->aos_epoch == p->aos_epoch && c->los_epoch == p->los_epoch && c->lat == of->lat && c->lon == of->lon && c->alt == of->alt)
+        {
+            c->last_used = ++sky_track_clock;
+            return c;
+        }
+        if (c->last_used < st->last_used)
+            st = c;
+    }
+
+    st->sat = p->sat;
+    st->aos_epoch = p->aos_epoch;
+    st->los_epoch = p->los_epoch;
+    st->lat = of->lat;
+    st->lon = of->lon;
+    st->alt = of->alt;
+    st->last_used = ++sky_track_clock;
+    st->num_pts = 0;
+
+    double step = (p->los_epoch - p->aos_epoch) / (SKY_TRACK_POINTS - 1);
+    if (!p->sat || step <= 0)
+        return st;
+    GmstSweep sw;
+    gmst_sweep_begin(&sw, p->aos_epoch, step);
+    for (int k = 0; k < SKY_TRACK_POINTS; k++, gmst_sweep_next(&sw))
+    {
+        double pt = p->aos_epoch + k * step;
+        double p_az, p_el;
+        observer_look(of, calculate_position(p->sat, get_unix_from_epoch(pt)), sw.sin_theta, sw.cos_theta, &p_az, &p_el);
+        st->pts[st->num_pts++] = (Vector2){(float)p_az, (float)p_el};
+    }
+    return st;
+}
+
+/* heavy lifting for pass prediction; brute force coarse search, then newton for the crossings. resumable, so
+   it can be spread across frames: pass_search_step picks up wherever the last one ran out of time. ps has to
+   be zeroed or left over from an earlier search, whatever that one had gets freed. passes get predicted for
+   home plus whichever sites are given, as many as fit in PASS_MAX_OBSERVERS; each sat only gets propagated
+   once per step however many there are */
+bool pass_search_begin(PassSearch *ps, Satellite *sat, double start_epoch, double days, float min_el, const Marker *sites, int num_sites)
+{
+    Marker observers[PASS_MAX_OBSERVERS];
+    int num_observers = 0;
+    observers[num_observers++] = home_location;
+    for (int i = 0; i < num_sites && num_observers < PASS_MAX_OBSERVERS; i++)
+        observers[num_observers++] = sites[i]; /* copied first, sites may well point into ps */
+
+    pass_search_abort(ps);
+    for (int k = 0; k < num_observers; k++)
+    {
+        ps->observers[k].site = observers[k];
+        observer_frame_init(&ps->observers[k].frame, observers[k].lat, observers[k].lon, observers[k].alt);
+    }
+    ps->num_observers = num_observers;
+    ps->sat = sat;
+    ps->days = fmax(1.0 / 24.0, fmin(PASS_MAX_HORIZON_DAYS, days));
+    ps->min_el = fmaxf(0.0f, fminf(89.0f, min_el));
+    ps->start_epoch = start_epoch;
+    ps->end_epoch = start_epoch + ps->days;
+    ps->changed = true; /* publish even if nothing turns up, so the old list goes away */
+    ps->rebuild = true;
+    return true;
+}
+
+/* slack on top of the spherical earth geometry in pass_possible and pass_always_up, for the oblate earth,
+   perturbations and float noise. anything they can't rule out with margin to spare gets searched the normal way */
+#define PASS_PREFILTER_MARGIN_DEG 2.0
+
+/* floor on the elevation the coarse step is sized for. catching passes that barely scrape the horizon
+   takes a step that goes to zero, and nobody is after those */
+#define PASS_CATCH_MIN_EL_DEG 0.5
+#define PASS_STEP_MIN (10.0 / 86400.0)
+#define PASS_STEP_MAX (20.0 / 1440.0)
+/* always-up sats only get stepped through to find the culmination */
+#define PASS_ALWAYS_UP_STEP (1.0 / 24.0)
+
+/* coarse step that can't jump clean over a pass reaching min_el: the time such a pass spends above the
+   horizon, for a circular orbit at perigee height (lowest and fastest, so the shortest passes) whose ground
+   track moves as fast as it ever could, orbit rate plus earth rotation. anything higher or slower stays up
+   longer. spherical earth, the observer's own altitude only makes passes longer */
+static double pass_coarse_step(const Satellite *sat, float min_el)
+{
+    double e = fmin(sat->eccentricity, 0.99);
+    double r = fmax(sat->semi_major_axis * (1.0 - e), WGS84_A + 100.0);
+    double rate = sat->mean_motion * (1.0 + e) * (1.0 + e) / pow(1.0 - e * e, 1.5) + EARTH_ROTATION_RATE;
+    double el = fmax(min_el, PASS_CATCH_MIN_EL_DEG) * DEG2RAD;
+    double q = WGS84_A / r;
+
+    double horizon = acos(q);                /* central angle out to where it's on the horizon */
+    double closest = acos(q * cos(el)) - el; /* and where it culminates at el */
+    double half = acos(fmin(1.0, cos(horizon) / cos(closest)));
+    double step = 2.0 * half / rate / 86400.0;
+    if (!(step > PASS_STEP_MIN))
+        return PASS_STEP_MIN;
+    return fmin(step, PASS_STEP_MAX);
+}
+
+/* near-geosynchronous sats barely move across the sky, so one that's high enough now can't set before the
+   window ends and there's nothing to search for but its max elevation. how far it can wander: inclination
+   and eccentricity swing it around its mean spot every day (either side, so twice over), the mean spot
+   drifts along the equator, and resonance speeds that drift up the staler the elements are. elevation
+   changes at most 1 / (1 - R / r) deg per deg of earth central angle the sub-satellite point moves */
+static bool pass_always_up(Satellite *sat, const ObserverFrame *of, double from, double days)
+{
+    double revs_per_day = sat->mean_motion * 86400.0 / (2.0 * SGPPI);
+    if (revs_per_day < 0.9 || revs_per_day > 1.1 || sat->eccentricity > 0.05)
+        return false;
+
+    double max_lat = (sat->inclination <= PI / 2.0) ? sat->inclination : SGPPI - sat->inclination;
+    double age_days = fabs(from - sat->epoch_days) + days;
+    double wander = 2.0 * (max_lat + 2.0 * sat->eccentricity + max_lat * max_lat / 4.0) +
+                    fabs(sat->mean_motion - EARTH_ROTATION_RATE) * days * 86400.0 +
+                    (0.05 * age_days + 0.0015 * age_days * age_days) * DEG2RAD;
+    double r_peri = sat->semi_major_axis * (1.0 - sat->eccentricity);
+    double el_drop = wander / (1.0 - WGS84_A / r_peri) * RAD2DEG;
+    return pass_elevation(sat, of, from) > el_drop + PASS_PREFILTER_MARGIN_DEG;
+}
+
+static void pass_scan_begin(PassScan *sc, Satellite *sat, const PassObserver *obs, int num_obs, double start_epoch, double step, bool back_up)
+{
+    double t = start_epoch;
+    double el[PASS_MAX_OBSERVERS];
+    double theta = epoch_to_gmst(t) * DEG2RAD;
+    pass_elevations(sat, obs, num_obs, t, sin(theta), cos(theta), el);
+
+    /* back up if happens to already be in a pass (anywhere) to catch the true start */
+    for (int i = 0; back_up && i < 30; i++)
+    {
+        bool up = false;
+        for (int k = 0; k < num_obs; k++)
+            up |= el[k] > 0;
+        if (!up)
+            break;
+        t -= (1.0 / 1440.0);
+        theta = epoch_to_gmst(t) * DEG2RAD;
+        pass_elevations(sat, obs, num_obs, t, sin(theta), cos(theta), el);
+    }
+
+    *sc = (PassScan){0};
+    sc->sat = sat;
+    sc->from = start_epoch;
+    sc->start = t;
+    sc->step = step;
+    sc->t = t;
+    gmst_sweep_begin(&sc->gmst, t, step);
+    for (int k = 0; k < num_obs; k++)
+        sc->looks[k].prev_el = el[k];
+}
+
+/* carries on at a different step, counted from the last sample so prev_el still brackets the next one */
+static void pass_scan_restep(PassScan *sc, double step)
+{
+    if (sc->step_idx > 0)
+    {
+        sc->start = sc->t - sc->step;
+        sc->step_idx = 1;
+    }
+    else
+        sc->start = sc->t;
+    sc->step = step;
+    sc->t = sc->start + sc->step_idx * step;
+    gmst_sweep_begin(&sc->gmst, sc->t, step);
+}
+
+/* the true max is within a coarse step of the best sample, or wherever the pass got cut off. an observer
+   that was clear at the start can turn up a pass from while the scan was backing up for another, that one's
+   over already */
+static void pass_scan_store(const PassScan *sc, const PassObserver *obs, int k, double los_epoch, PassList *out)
+{
+    const PassScanLook *look = &sc->looks[k];
+    if (los_epoch < sc->from)
+        return;
+    SatPass p = {0};
+    p.sat = sc->sat;
+    p.observer = k;
+    p.aos_epoch = look->aos_epoch;
+    p.los_epoch = los_epoch;
+    pass_find_culmination(sc->sat, &obs[k].frame, &p, fmax(p.aos_epoch, look->max_el_epoch - sc->step), fmin(los_epoch, look->max_el_epoch + sc->step));
+    pass_list_push(out, &p);
+}
+
+/* coarse steps for one sat until its window is done (true). with a finite
+   deadline the clock gets checked every 32 steps and it hands back false to be picked up again later.
+   a pass still going at the end stays open in the scan, so a longer window can pick it up from there */
+static bool pass_scan_run(PassScan *sc, const PassObserver *obs, int num_obs, int steps, PassList *out, double deadline_ms)
+{
+    int since_check = 0;
+    for (; sc->step_idx < steps; sc->step_idx++, sc->t += sc->step, gmst_sweep_next(&sc->gmst))
+    {
+        if (deadline_ms < INFINITY && ++since_check >= 32)
+        {
+            since_check = 0;
+            if (WorkerClockMs() >= deadline_ms)
+                return false;
+        }
+
+        double els[PASS_MAX_OBSERVERS];
+        pass_elevations(sc->sat, obs, num_obs, sc->gmst.epoch, sc->gmst.sin_theta, sc->gmst.cos_theta, els);
+        for (int k = 0; k < num_obs; k++)
+        {
+            PassScanLook *look = &sc->looks[k];
+            const ObserverFrame *of = &obs[k].frame;
+            double el = els[k];
+            double prev_el = look->prev_el;
+            look->prev_el = el;
+            if (el >= 0.0)
+            {
+                if (!look->in_pass)
+                {
+                    look->in_pass = true;
+                    look->aos_epoch = (prev_el < 0.0) ? pass_find_crossing(sc->sat, of, sc->t - sc->step, prev_el, sc->t, el) : sc->t;
+                    look->max_el = el;
+                    look->max_el_epoch = sc->t;
+                }
+                if (el > look->max_el)
+                {
+                    look->max_el = el;
+                    look->max_el_epoch = sc->t;
+                }
+            }
+            else if (look->in_pass)
+            {
+                look->in_pass = false;
+                pass_scan_store(sc, obs, k, pass_find_crossing(sc->sat, of, sc->t - sc->step, prev_el, sc->t, el), out);
+            }
+        }
+    }
+    return true;
+}
+
+#define WGS84_B 6356.752
+
+/* can sat get above home's horizon at all during [start_epoch, start_epoch + days]? plain geometry off the
+   elements, no sgp4. the ground track never gets further from the equator than the inclination, and from
+   apogee the sat clears the horizon out to acos(R / r) of earth central angle. near-geosynchronous sats
+   hardly move over the ground, so for those the longitude they can reach over the window gets checked too */
+static bool pass_possible(const Satellite *sat, const ObserverFrame *home, double start_epoch, double days)
+{
+    /* drag runs the show down low, and decayed or garbage elements are anyone's guess. search those */
+    double r_apo = sat->semi_major_axis * (1.0 + sat->eccentricity);
+    double r_peri = sat->semi_major_axis * (1.0 - sat->eccentricity);
+    if (!(r_peri > WGS84_A + 200.0))
+        return true;
+
+    /* polar radius is the conservative end; a raised observer sees a bit past their own horizon too */
+    double obs_r = WGS84_B + fmax(0.0, home->alt / 1000.0);
+    double reach = acos(WGS84_B / r_apo) + acos(WGS84_B / obs_r);
+    double max_lat = (sat->inclination <= PI / 2.0) ? sat->inclination : SGPPI - sat->inclination;
+    double obs_lat = home->lat * DEG2RAD;
+    double margin = PASS_PREFILTER_MARGIN_DEG * DEG2RAD;
+
+    if (fabs(obs_lat) - max_lat > reach + margin)
+        return false;
+
+    double revs_per_day = sat->mean_motion * 86400.0 / (2.0 * SGPPI);
+    if (revs_per_day < 0.9 || revs_per_day > 1.1 || sat->eccentricity > 0.05)
+        return true;
+
+    /* right ascension from the mean elements. eccentricity and inclination pull the real one away from
+       this, and so does time: the geopotential resonance accelerates these along in longitude by up to
+       about 0.002 deg/day^2, so stale elements quickly get margin enough to not rule anything out */
+    double age_days = fabs(start_epoch - sat->epoch_days) + days;
+    margin += 2.0 * sat->eccentricity + max_lat * max_lat / 4.0 + (0.05 * age_days + 0.0015 * age_days * age_days) * DEG2RAD;
+
+    double dt = get_unix_from_epoch(start_epoch) - sat->epoch_unix;
+    double ra = sat->raan + sat->arg_perigee + sat->mean_anomaly + sat->mean_motion * dt;
+    double lon = ra - epoch_to_gmst(start_epoch) * DEG2RAD - home->lon * DEG2RAD;
+    double drift = (sat->mean_motion - EARTH_ROTATION_RATE) * days * 86400.0;
+    if (fabs(drift) >= 2.0 * SGPPI)
+        return true;
+    if (drift < 0)
+    {
+        lon += drift;
+        drift = -drift;
+    }
+
+    /* smallest longitude gap to the observer anywhere in [lon, lon + drift] */
+    lon = fmod(lon, 2.0 * SGPPI);
+    if (lon < -SGPPI)
+        lon += 2.0 * SGPPI;
+    else if (lon >= SGPPI)
+        lon -= 2.0 * SGPPI;
+    double end = lon + drift;
+    double dlon;
+    if ((lon <= 0.0 && end >= 0.0) || end >= 2.0 * SGPPI)
+        dlon = 0.0;
+    else if (end < 0.0)
+        dlon = -end;
+    else
+        dlon = fmin(lon, 2.0 * SGPPI - end);
+
+    /* closest central angle over every latitude the sat can be at */
+    double a = sin(obs_lat), b = cos(obs_lat) * cos(dlon);
+    double lat = fmax(-max_lat, fmin(max_lat, atan2(a, b)));
+    double closest = acos(fmax(-1.0, fmin(1.0, a * sin(lat) + b * cos(lat))));
+    return closest <= reach + margin;
+}
+
+static bool pass_tracks_reserve(PassSearch *ps, int count)
+{
+    if (count <= ps->track_capacity)
+        return true;
+    PassTrack *grown = (PassTrack *)realloc(ps->tracks, count * sizeof(PassTrack));
+    if (!grown)
+        return false;
+    memset(grown + ps->track_capacity, 0, (count - ps->track_capacity) * sizeof(PassTrack));
+    ps->tracks = grown;
+    ps->track_capacity = count;
+    return true;
+}
+
+static void pass_track_reset(PassTrack *tr)
+{
+    pass_list_free(&tr->passes);
+    *tr = (PassTrack){0};
+}
+
+/* the pass cache: every active sat's track from the last finished all-sats search, kept on disk between runs.
+   a later search for the same observers, min elevation and horizon whose window starts inside the cached one
+   picks each sat up from its cached track as if the window had just slid along, so only the bit of window
+   that's new gets searched. tracks are found by NORAD id and only used while the TLE epoch still matches */
+#define PASS_CACHE_MAGIC 0x31435054  // "TPC1"
+#define PASS_CACHE_VERSION 2         // bump whenever what gets written per field changes
+#define PASS_CACHE_MAX_ENTRIES (1 << 20)
+#define PASS_CACHE_MAX_TRACK_PASSES (1 << 16)  // 28 days of the lowest LEO from 8 sites is a few thousand
+
+typedef struct
+{
+    char norad_id[6];
+    double epoch_days;  // of the TLE the track was searched with
+    PassTrack track;    // scan.sat and the passes' sat get pointed at the sat again when it's used
+} PassCacheEntry;
+
+static struct
+{
+    Marker observers[PASS_MAX_OBSERVERS];  // only lat/lon/alt have to match
+    int num_observers;
+    float min_el;
+    double days;
+    double start_epoch;       // tracks are searched up to start_epoch + days
+    PassCacheEntry *entries;  // sorted by norad_id
+    int count;
+    bool dirty;               // changed since it was last saved
+} pass_cache;
+
+static int compare_cache_entries(const void *a, const void *b)
+{
+    return strncmp(((const PassCacheEntry *)a)->norad_id, ((const PassCacheEntry *)b)->norad_id, sizeof(((PassCacheEntry *)0)->norad_id));
+}
+
+static bool pass_cache_usable(const PassSearch *ps)
+{
+    if (pass_cache.count == 0 || pass_cache.num_observers != ps->num_observers || pass_cache.min_el != ps->min_el || pass_cache.days != ps->days)
+        return false;
+    /* the window can only have moved forward, and not past everything that was searched */
+    if (ps->start_epoch < pass_cache.start_epoch || ps->start_epoch >= pass_cache.start_epoch + pass_cache.days)
+        return false;
+    for (int k = 0; k < ps->num_observers; k++)
+    {
+        const Marker *a = &pass_cache.observers[k], *b = &ps->observers[k].site;
+        if (a->lat != b->lat || a->lon != b->lon || a->alt != b->alt)
+            return false;
+    }
+    return true;
+}
+
+static void pass_cache_clear(void)
+{
+    for (int i = 0; i < pass_cache.count; i++)
+        pass_list_free(&pass_cache.entries[i].track.passes);
+    free(pass_cache.entries);
+    pass_cache.entries = NULL;
+    pass_cache.count = 0;
+}
+
+/* starts a fresh track off from the cache. passes that are over by now get dropped and the rest, open ones
+   included, stay in order, so it's in the same state a slide would have left it in. false if there's
+   nothing cached for this sat as it is now */
+static bool pass_cache_seed(const PassSearch *ps, PassTrack *tr, Satellite *sat)
+{
+    if (!pass_cache_usable(ps))
+        return false;
+    PassCacheEntry key;
+    memcpy(key.norad_id, sat->norad_id, sizeof(key.norad_id));
+    const PassCacheEntry *e = (const PassCacheEntry *)bsearch(&key, pass_cache.entries, pass_cache.count, sizeof(PassCacheEntry), compare_cache_entries);
+    if (!e || e->epoch_days != sat->epoch_days)
+        return false;
+
+    *tr = e->track;
+    tr->passes = (PassList){0};
+    tr->published = 0;
+    memset(tr->retracted_aos, 0, sizeof(tr->retracted_aos));
+    tr->scan.sat = sat;
+    for (int j = 0; j < e->track.passes.count; j++)
+    {
+        SatPass p = e->track.passes.items[j];
+        if (p.los_epoch < ps->start_epoch)
+            continue;
+        p.sat = sat;
+        if (!pass_list_push(&tr->passes, &p))
+        {
+            pass_track_reset(tr);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* what one pass_track_run did, for the caller to add up */
+typedef struct
+{
+    int candidates;
+    int rejected;
+    int added;     // change in the track's pass count
+    bool changed;  // its list is different in any way
+} PassTrackResult;
+
+/* brings one sat's track up to the end of the window. passes that got cut off last time come out so they can
+   be followed to their real LOS, stretches the sat can't be seen in from anywhere are ruled out with
+   pass_possible, and the rest gets scanned. false = ran out of time, call again */
+static bool pass_track_run(const PassSearch *ps, PassTrack *tr, Satellite *sat, double deadline_ms, PassTrackResult *res)
+{
+    const PassObserver *obs = ps->observers;
+    int num_obs = ps->num_observers;
+
+    if (!tr->started && tr->until == 0.0 && sat_active[sat->id] && pass_cache_seed(ps, tr, sat))
+    {
+        res->added += tr->passes.count;
+        res->changed = true;
+    }
+    if (tr->until >= ps->end_epoch)
+        return true;
+    if (!sat_active[sat->id])
+    {
+        tr->until = ps->end_epoch;
+        return true;
+    }
+
+    int before = tr->passes.count;
+    for (; tr->open > 0; tr->open--)
+    {
+        tr->passes.count--;
+        res->changed = true;
+        if (tr->published > tr->passes.count)
+        {
+            const SatPass *p = &tr->passes.items[tr->passes.count];
+            tr->published = tr->passes.count;
+            tr->retracted_aos[p->observer] = p->aos_epoch;
+        }
+    }
+
+    /* fresh stretch of window, see if there's any point. a sat that's up right now obviously can be seen.
+       if it's always up (or never) from every observer, there's nothing to step through closely */
+    if (!tr->checked)
+    {
+        double from = fmax(tr->started ? tr->scan.t : tr->until, ps->start_epoch);
+        double days = ps->end_epoch - from;
+        bool possible = false, always_up = true;
+        for (int k = 0; k < num_obs; k++)
+        {
+            if (!(tr->started && tr->scan.looks[k].in_pass) && !pass_possible(sat, &obs[k].frame, from, days))
+                continue;
+            possible = true;
+            if (always_up && !pass_always_up(sat, &obs[k].frame, from, days))
+                always_up = false;
+        }
+        res->candidates++;
+        if (!possible)
+        {
+            res->rejected++;
+            tr->started = false;
+            tr->until = ps->end_epoch;
+            res->added += tr->passes.count - before;
+            return true;
+        }
+        double step = always_up ? PASS_ALWAYS_UP_STEP : pass_coarse_step(sat, ps->min_el);
+        if (!tr->started)
+        {
+            pass_scan_begin(&tr->scan, sat, obs, num_obs, from, step, !always_up);
+            tr->started = true;
+        }
+        else if (step != tr->scan.step)
+            pass_scan_restep(&tr->scan, step);
+        tr->checked = true;
+    }
+
+    int steps = (int)ceil((ps->end_epoch - tr->scan.start) / tr->scan.step);
+    bool done = pass_scan_run(&tr->scan, obs, num_obs, steps, &tr->passes, deadline_ms);
+    if (done)
+    {
+        /* still up when the search window ran out. with steps this long a pass can also come up between the
+           last sample and the end, so one look at the end itself; the scan carries on from its own grid next
+           slide and finds that one properly */
+        double els[PASS_MAX_OBSERVERS];
+        double theta = epoch_to_gmst(ps->end_epoch) * DEG2RAD;
+        pass_elevations(sat, obs, num_obs, ps->end_epoch, sin(theta), cos(theta), els);
+        for (int k = 0; k < num_obs; k++)
+        {
+            const PassScanLook *look = &tr->scan.looks[k];
+            if (look->in_pass)
+                pass_scan_store(&tr->scan, obs, k, ps->end_epoch, &tr->passes);
+            else if (els[k] >= 0.0)
+            {
+                SatPass p = {0};
+                p.sat = sat;
+                p.observer = k;
+                p.aos_epoch = pass_find_crossing(sat, &obs[k].frame, tr->scan.t - tr->scan.step, look->prev_el, ps->end_epoch, els[k]);
+                p.los_epoch = ps->end_epoch;
+                pass_find_culmination(sat, &obs[k].frame, &p, p.aos_epoch, p.los_epoch);
+                pass_list_push(&tr->passes, &p);
+            }
+            else
+                continue;
+            tr->open++;
+        }
+        tr->until = ps->end_epoch;
+        tr->checked = false;
     }
+    res->added += tr->passes.count - before;
+    if (tr->passes.count != before)
+        res->changed = true;
+    return done;
 }
 
-/* main sgp4 crank; outputs raw ECI coordinates */
-/* precalculated unix time passed down to prevent excessyear/day conversions */
-Vector3 calculate_position(Satellite *sat, double current_unix)
+static void pass_search_add(PassSearch *ps, const PassTrackResult *res)
 {
-    double tsince = (current_unix - sat->epoch_unix) / 60.0;
-
-    double ro[3] = {0};
-    double vo[3] = {0};
-
-    sgp4(&sat->satrec, tsince, ro, vo);
-
-    Vector3 pos;
-    pos.x = (float)(ro[0]);
-    pos.y = (float)(ro[2]);
-    pos.z = (float)(-ro[1]);
-
-    return pos;
+    ps->candidates += res->candidates;
+    ps->rejected += res->rejected;
+    ps->pass_count += res->added;
+    if (res->changed)
+        ps->changed = true;
 }
 
-/* projects 3D orbital space onto a 2D equirectangular map plane */
-void get_map_coordinates(Vector3 pos, double gmst_deg, float earth_offset, float map_w, float map_h, float *out_x, float *out_y)
+/* one sat, searched on the calling thread and resumable partway through */
+static bool pass_search_step_single(PassSearch *ps, double deadline_ms)
 {
-    float r = Vector3Length(pos);
-    if (r == 0)
-        r = 0.0001f;
-    float phi = acosf(pos.y / r);
-    float v = phi / PI;
+    if (ps->next > 0)
+        return true;
+    if (!pass_tracks_reserve(ps, 1))
+        return true;
+    ps->sat_idx = 1; /* taken on right away, so whatever it finds gets published as it goes */
 
-    float theta_sat = atan2f(-pos.z, pos.x);
-    float R_rad = (gmst_deg + earth_offset) * DEG2RAD;
-    float theta_tex = theta_sat - R_rad;
+    PassTrackResult res = {0};
+    bool done = pass_track_run(ps, &ps->tracks[0], ps->sat, deadline_ms, &res);
+    pass_search_add(ps, &res);
+    if (!done)
+        return false;
+    ps->next = 1;
+    return true;
+}
 
-    while (theta_tex > PI)
-        theta_tex -= 2.0f * PI;
-    while (theta_tex < -PI)
-        theta_tex += 2.0f * PI;
+/* all-sats mode hands out batches of tracks to the worker pool. every sat has its own track and list, so
+   the workers never share a buffer and the result doesn't depend on how the batches got split up */
+#define PASS_BATCH_MAX 512
 
-    float u = theta_tex / (2.0f * PI) + 0.5f;
-    *out_x = (u - 0.5f) * map_w;
-    *out_y = (v - 0.5f) * map_h;
+typedef struct
+{
+    const PassSearch *ps;
+    int first;  // satellites[] index of the first track
+    volatile int candidates;
+    volatile int rejected;
+    volatile int added;
+    volatile int changed;
+} PassBatch;
+
+static void pass_batch_job(void *user, int start, int end)
+{
+    PassBatch *batch = (PassBatch *)user;
+    PassTrackResult res = {0};
+    for (int i = batch->first + start; i < batch->first + end; i++)
+    {
+        Satellite *sat = satellites[i];
+        if (sat)
+            pass_track_run(batch->ps, &batch->ps->tracks[i], sat, INFINITY, &res);
+    }
+    __sync_fetch_and_add(&batch->candidates, res.candidates);
+    __sync_fetch_and_add(&batch->rejected, res.rejected);
+    __sync_fetch_and_add(&batch->added, res.added);
+    if (res.changed)
+        __sync_fetch_and_or(&batch->changed, 1);
 }
 
-/* finds where the sat hits the high and low points of its orbit in 2D */
-void get_apsis_2d(Satellite *sat, double current_time, bool is_apoapsis, double gmst_deg, float earth_offset, float map_w, float map_h, Vector2 *out)
+/* true once every track is up to date. first the ones already taken on get brought up to end_epoch, then
+   the rest of the catalog gets taken on in order. a batch can't be interrupted, so batches
+   get sized off how long the last one took per sat to land near the deadline; each call still always does
+   at least one */
+bool pass_search_step(PassSearch *ps, double deadline_ms)
 {
-    (void)gmst_deg;
-
-    double current_unix = get_unix_from_epoch(current_time);
-    double delta_time_s = current_unix - sat->epoch_unix;
+    if (ps->sat)
+        return pass_search_step_single(ps, deadline_ms);
 
-    double M = fmod(sat->mean_anomaly + sat->mean_motion * delta_time_s, 2.0 * PI);
-    if (M < 0)
-        M += 2.0 * PI;
-
-    double target_M = is_apoapsis ? PI : 0.0;
-    double diff = target_M - M;
-    if (diff < 0)
-        diff += 2.0 * PI;
+    int lanes = WorkerPoolThreadCount() + 1;
+    bool did_batch = false;
 
-    double t_target = current_time + (diff / sat->mean_motion) / 86400.0;
-    double t_target_unix = get_unix_from_epoch(t_target);
-    Vector3 pos3d = calculate_position(sat, t_target_unix);
-    double gmst_target = epoch_to_gmst(t_target);
+    while (1)
+    {
+        bool taking_on = (ps->next >= ps->sat_idx);
+        if (taking_on && ps->sat_idx >= sat_count)
+            break;
+        if (!pass_tracks_reserve(ps, sat_count))
+            break;
 
-    get_map_coordinates(pos3d, gmst_target, earth_offset, map_w, map_h, &out->x, &out->y);
+        int batch_size = PASS_BATCH_MAX;
+        if (deadline_ms < INFINITY)
+        {
+            double left = deadline_ms - WorkerClockMs();
+            if (did_batch && left <= 0)
+                return false;
+            batch_size = lanes;
+            if (ps->ms_per_sat > 0 && left > 0)
+                batch_size = (int)fmin(PASS_BATCH_MAX, fmax(lanes, left / ps->ms_per_sat));
+        }
+        int count = (taking_on ? sat_count : ps->sat_idx) - ps->next;
+        if (count > batch_size)
+            count = batch_size;
+
+        PassBatch batch = {ps, ps->next, 0, 0, 0, 0};
+        double t0 = WorkerClockMs();
+        WorkerPoolParallelFor(count, 1, pass_batch_job, &batch);
+        double per_sat = (WorkerClockMs() - t0) / count;
+        ps->ms_per_sat = ps->ms_per_sat > 0 ? (ps->ms_per_sat + per_sat) * 0.5 : per_sat;
+
+        PassTrackResult res = {batch.candidates, batch.rejected, batch.added, batch.changed != 0};
+        pass_search_add(ps, &res);
+        ps->next += count;
+        if (ps->next > ps->sat_idx)
+            ps->sat_idx = ps->next;
+        did_batch = true;
+    }
+    return true;
 }
 
-/* predicts the timestamps for the next perigee and apoapsis */
-void get_apsis_times(Satellite *sat, double current_time, double *out_peri_unix, double *out_apo_unix)
+/* moves the window up to start at now: passes that are over get dropped and every track only has to be
+   searched across the bit of window that's new. a jump backwards or past the end of the window leaves
+   nothing worth keeping, so that starts over. true if there's searching to do */
+bool pass_search_slide(PassSearch *ps, double now)
 {
-    double current_unix = get_unix_from_epoch(current_time);
-    double delta_time_s = current_unix - sat->epoch_unix;
+    if (now < ps->start_epoch || now >= ps->end_epoch)
+    {
+        Marker sites[PASS_MAX_OBSERVERS];
+        for (int k = 1; k < ps->num_observers; k++)
+            sites[k - 1] = ps->observers[k].site;
+        return pass_search_begin(ps, ps->sat, now, ps->days, ps->min_el, sites, ps->num_observers - 1);
+    }
 
-    double M = fmod(sat->mean_anomaly + sat->mean_motion * delta_time_s, 2.0 * PI);
-    if (M < 0)
-        M += 2.0 * PI;
+    /* lists are only roughly in LOS order across observers, so go through all of it */
+    for (int i = 0; i < ps->sat_idx; i++)
+    {
+        PassTrack *tr = &ps->tracks[i];
+        int kept = 0, published = 0;
+        for (int j = 0; j < tr->passes.count; j++)
+        {
+            if (tr->passes.items[j].los_epoch < now)
+                continue;
+            if (j < tr->published)
+                published++;
+            tr->passes.items[kept++] = tr->passes.items[j];
+        }
+        if (kept == tr->passes.count)
+            continue;
+        ps->pass_count -= tr->passes.count - kept;
+        tr->passes.count = kept;
+        tr->published = published;
+        ps->changed = true;
+    }
 
-    double diff_peri = 0.0 - M;
-    if (diff_peri < 0)
-        diff_peri += 2.0 * PI;
-    double diff_apo = PI - M;
-    if (diff_apo < 0)
-        diff_apo += 2.0 * PI;
+    ps->start_epoch = now;
+    ps->end_epoch = now + ps->days;
+    ps->next = 0;
+    ps->candidates = 0;
+    ps->rejected = 0;
+    return true;
+}
 
-    double t_peri = current_time + (diff_peri / sat->mean_motion) / 86400.0;
-    double t_apo = current_time + (diff_apo / sat->mean_motion) / 86400.0;
+/* forgets everything about sat (checked or unchecked) and searches it again on the next step. false if it
+   isn't part of this search or hasn't been gotten to yet */
+bool pass_search_refresh_sat(PassSearch *ps, Satellite *sat)
+{
+    int idx = ps->sat ? (sat == ps->sat ? 0 : -1) : sat->id;
+    if (idx < 0 || idx >= ps->sat_idx)
+        return false;
 
-    *out_peri_unix = get_unix_from_epoch(t_peri);
-    *out_apo_unix = get_unix_from_epoch(t_apo);
+    PassTrack *tr = &ps->tracks[idx];
+    ps->pass_count -= tr->passes.count;
+    if (tr->published > 0)
+        ps->rebuild = true;
+    pass_track_reset(tr);
+    if (ps->next > idx)
+        ps->next = idx;
+    ps->changed = true;
+    return true;
 }
 
-/* Calculates cache resolution based on orbital eccentricity */
-int calculate_orbit_cache_resolution(double eccentricity, int active_sat_count, int total_sat_count)
+float pass_search_progress(const PassSearch *ps)
 {
-    (void)active_sat_count;  // unused
-    (void)total_sat_count;   // unused
-    
-    // Low eccentricity
-    if (eccentricity < 0.05)
-        return 180;
-    // Moderate eccentricity
-    if (eccentricity < 0.3)
-        return 270;
-    // High eccentricity
-    return 361;
+    int target_count = ps->sat ? 1 : sat_count;
+    if (target_count <= 0)
+        return 1.0f;
+    float within = 0.0f;
+    if (ps->sat && ps->next == 0 && ps->tracks && ps->tracks[0].checked)
+        within = (float)fmin(1.0, fmax(0.0, (ps->tracks[0].scan.t - ps->start_epoch) / (ps->end_epoch - ps->start_epoch)));
+    return (ps->next + within) / target_count;
 }
 
-/* Checks if cached orbit is still valid based on satellite drift */
-bool is_orbit_cache_valid(Satellite *sat, Vector3 current_pos, float drift_threshold_km)
+static bool pass_buffer_reserve(int half, int count)
 {
-    if (!sat->orbit_cached)
+    if (count <= pass_buffer_capacity[half])
+        return true;
+    int new_capacity = pass_buffer_capacity[half] ? pass_buffer_capacity[half] : 256;
+    while (new_capacity < count)
+        new_capacity *= 2;
+    SatPass *grown = (SatPass *)realloc(pass_buffers[half], new_capacity * sizeof(SatPass));
+    if (!grown)
         return false;
-    
-    float drift = Vector3Distance(sat->cached_orbit_base_pos, current_pos);
-    return drift < drift_threshold_km;
+    pass_buffers[half] = grown;
+    pass_buffer_capacity[half] = new_capacity;
+    return true;
 }
 
-/* bakes the future orbital path into a vertex buffer so sgp4 isnt re-ran every frame */
-void update_orbit_cache(Satellite *sat, double current_epoch)
+/* swaps whatever has been found so far in as the visible list, sorted. readers only ever look at passes[]
+   from the main thread within a frame and this runs between them, so they get the old list or the new one,
+   never something in between. normally only the passes found since last time need sorting, and they get
+   merged into the list that's up already, minus whatever a slide dropped or a track took back. a refresh
+   rebuilds it from every track. false if there was nothing new to show */
+bool pass_search_publish(PassSearch *ps)
 {
-    sat->orbit_cache_resolution = calculate_orbit_cache_resolution(sat->eccentricity, 0, sat_count);
-    
-    double period_days = (2.0 * PI / sat->mean_motion) / 86400.0;
-    double time_step = period_days / (sat->orbit_cache_resolution - 1);
-    
-    for (int i = 0; i < sat->orbit_cache_resolution; i++)
+    prop_stats.pass_candidates = ps->candidates;
+    prop_stats.pass_rejected = ps->rejected;
+    if (!ps->changed)
+        return false;
+
+    static const SatPass **order = NULL;
+    static int order_capacity = 0;
+    if (ps->pass_count > order_capacity)
     {
-        double t = current_epoch + (i * time_step);
-        double t_unix = get_unix_from_epoch(t);
-        sat->orbit_cache[i] = Vector3Scale(calculate_position(sat, t_unix), 1.0f / DRAW_SCALE);
+        const SatPass **grown = (const SatPass **)realloc(order, ps->pass_count * sizeof(order[0]));
+        if (!grown)
+            return false;
+        order = grown;
+        order_capacity = ps->pass_count;
     }
-    
-    // Track cache validity
-    double current_unix = get_unix_from_epoch(current_epoch);
-    sat->cached_orbit_base_pos = calculate_position(sat, current_unix);
-    sat->cached_orbit_epoch = current_epoch;
-    sat->orbit_cached = true;
-}
+    int kept = ps->rebuild ? 0 : num_passes;
+    int back_half = (passes == pass_buffers[0]) ? 1 : 0;
+    if (!pass_buffer_reserve(back_half, kept + ps->pass_count))
+        return false;
+    SatPass *back = pass_buffers[back_half];
 
-/* converts raw orbital data into azimuth/elevation for a specific ground station */
-void get_az_el(Vector3 eci_pos, double gmst_deg, float obs_lat, float obs_lon, float obs_alt, double *az, double *el)
-{
-    double sat_r = Vector3Length(eci_pos);
-    if (sat_r == 0)
+    int n = 0;
+    for (int i = 0; i < ps->sat_idx; i++)
     {
-        *az = 0;
-        *el = -90;
-        return;
+        PassTrack *tr = &ps->tracks[i];
+        for (int j = ps->rebuild ? 0 : tr->published; j < tr->passes.count; j++)
+            order[n++] = &tr->passes.items[j];
+        tr->published = tr->passes.count;
     }
+    qsort(order, n, sizeof(order[0]), compare_pass_ptrs);
 
-    double sat_lat = asin(eci_pos.y / sat_r);
-    double sat_lon_eci = atan2(-eci_pos.z, eci_pos.x);
-    double theta = (gmst_deg + 0) * DEG2RAD; /* assuming earth_rotation_offset handled befor */
-    double sat_lon_ecef = sat_lon_eci - theta;
+    int a = 0, b = 0, out = 0;
+    while (a < kept || b < n)
+    {
+        if (a < kept)
+        {
+            const SatPass *p = &passes[a];
+            const PassTrack *tr = &ps->tracks[ps->sat ? 0 : p->sat->id];
+            if (p->los_epoch < ps->start_epoch || p->aos_epoch == tr->retracted_aos[p->observer])
+            {
+                a++;
+                continue;
+            }
+        }
+        if (b == n || (a < kept && compare_passes(&passes[a], order[b]) <= 0))
+            back[out++] = passes[a++];
+        else
+            back[out++] = *order[b++];
+    }
+    for (int i = 0; i < ps->sat_idx; i++)
+        memset(ps->tracks[i].retracted_aos, 0, sizeof(ps->tracks[i].retracted_aos));
+
+    passes = back;
+    num_passes = out;
+    memcpy(pass_observers, ps->observers, sizeof(pass_observers));
+    num_pass_observers = ps->num_observers;
+    last_pass_calc_sat = ps->sat;
+    ps->changed = false;
+    ps->rebuild = false;
+    return true;
+}
 
-    double s_x = sat_r * cos(sat_lat) * cos(sat_lon_ecef);
-    double s_y = sat_r * cos(sat_lat) * sin(sat_lon_ecef);
-    double s_z = sat_r * sin(sat_lat);
+/* final publish and cleanup */
+void pass_search_finish(PassSearch *ps)
+{
+    pass_search_publish(ps);
+    pass_search_abort(ps);
+}
 
-    double o_x, o_y, o_z;
-    geodetic_to_ecef(obs_lat, obs_lon, obs_alt, &o_x, &o_y, &o_z);
+/* frees everything, leaving ps zeroed */
+void pass_search_abort(PassSearch *ps)
+{
+    for (int i = 0; i < ps->track_capacity; i++)
+        pass_list_free(&ps->tracks[i].passes);
+    free(ps->tracks);
+    *ps = (PassSearch){0};
+}
 
-    double dx = s_x - o_x;
-    double dy = s_y - o_y;
-    double dz = s_z - o_z;
+/* replaces the pass cache with a finished all-sats search. sats that weren't active got skipped rather than
+   searched, so they're left out */
+void pass_cache_store(const PassSearch *ps)
+{
+    if (ps->sat || ps->next < sat_count)
+        return;
+    pass_cache_clear();
+    pass_cache.entries = (PassCacheEntry *)malloc((ps->sat_idx > 0 ? ps->sat_idx : 1) * sizeof(PassCacheEntry));
+    if (!pass_cache.entries)
+        return;
 
-    double lat_rad = obs_lat * DEG2RAD;
-    double lon_rad = obs_lon * DEG2RAD;
-    double clat = cos(lat_rad);
-    double slat = sin(lat_rad);
-    double clon = cos(lon_rad);
-    double slon = sin(lon_rad);
+    for (int k = 0; k < ps->num_observers; k++)
+        pass_cache.observers[k] = ps->observers[k].site;
+    pass_cache.num_observers = ps->num_observers;
+    pass_cache.min_el = ps->min_el;
+    pass_cache.days = ps->days;
+    pass_cache.start_epoch = ps->start_epoch;
+    for (int i = 0; i < ps->sat_idx; i++)
+    {
+        const PassTrack *tr = &ps->tracks[i];
+        if (!satellites[i] || !sat_active[i] || tr->until < ps->end_epoch)
+            continue;
+        PassCacheEntry *e = &pass_cache.entries[pass_cache.count];
+        memcpy(e->norad_id, satellites[i]->norad_id, sizeof(e->norad_id));
+        e->epoch_days = satellites[i]->epoch_days;
+        e->track = *tr;
+        e->track.passes = (PassList){0};
+        bool ok = true;
+        for (int j = 0; j < tr->passes.count && ok; j++)
+            ok = pass_list_push(&e->track.passes, &tr->passes.items[j]);
+        if (!ok)
+        {
+            pass_list_free(&e->track.passes);
+            continue;
+        }
+        pass_cache.count++;
+    }
+    qsort(pass_cache.entries, pass_cache.count, sizeof(PassCacheEntry), compare_cache_entries);
+    pass_cache.dirty = true;
+}
 
-    double east = -slon * dx + clon * dy;
-    double north = -slat * clon * dx - slat * slon * dy + clat * dz;
-    double up = clat * clon * dx + clat * slon * dy + slat * dz;
+/* the file is written one field at a time in host byte order: no struct padding, no pointers. sat pointers
+   stay NULL on load and get set by pass_cache_seed, which looks the sat up by NORAD id */
+#define PASS_CACHE_PUT(f, v) fwrite(&(v), sizeof(v), 1, (f))
+#define PASS_CACHE_GET(f, v) (fread(&(v), sizeof(v), 1, (f)) == 1)
 
-    *el = atan2(up, sqrt(east * east + north * north)) * RAD2DEG;
-    *az = atan2(east, north) * RAD2DEG;
-    if (*az < 0)
-        *az += 360.0;
+static void pass_cache_put_flag(FILE *f, bool b)
+{
+    unsigned char c = b ? 1 : 0;
+    PASS_CACHE_PUT(f, c);
 }
 
-/* qsort callback to keep passes chronological */
-int compare_passes(const void *a, const void *b)
+static bool pass_cache_get_flag(FILE *f, bool *b)
 {
-    const SatPass *p1 = (const SatPass *)a;
-    const SatPass *p2 = (const SatPass *)b;
-    if (p1->aos_epoch < p2->aos_epoch)
-        return -1;
-    if (p1->aos_epoch > p2->aos_epoch)
-        return 1;
-    return 0;
+    unsigned char c;
+    if (!PASS_CACHE_GET(f, c) || c > 1)
+        return false;
+    *b = c;
+    return true;
 }
 
-/* heavy lifting for pass prediction; brute force search with binary search refinement */
-void CalculatePasses(Satellite *sat, double start_epoch)
+static void pass_cache_put_entry(FILE *f, const PassCacheEntry *e, int num_observers)
 {
-    num_passes = 0;
-    last_pass_calc_sat = sat;
-
-    int target_count = sat ? 1 : sat_count;
-    int max_days = sat ? 3 : 1;
-    double coarse_step = sat ? (1.0 / 1440.0) : (4.0 / 1440.0);
-
-    for (int s = 0; s < target_count; s++)
+    const PassTrack *tr = &e->track;
+    const PassScan *sc = &tr->scan;
+    fwrite(e->norad_id, 1, sizeof(e->norad_id), f);
+    PASS_CACHE_PUT(f, e->epoch_days);
+
+    PASS_CACHE_PUT(f, tr->until);
+    pass_cache_put_flag(f, tr->started);
+    pass_cache_put_flag(f, tr->checked);
+    PASS_CACHE_PUT(f, tr->open);
+
+    PASS_CACHE_PUT(f, sc->from);
+    PASS_CACHE_PUT(f, sc->start);
+    PASS_CACHE_PUT(f, sc->step);
+    PASS_CACHE_PUT(f, sc->step_idx);
+    PASS_CACHE_PUT(f, sc->t);
+    PASS_CACHE_PUT(f, sc->gmst.epoch);
+    PASS_CACHE_PUT(f, sc->gmst.step_days);
+    PASS_CACHE_PUT(f, sc->gmst.step_deg);
+    PASS_CACHE_PUT(f, sc->gmst.gmst_deg);
+    PASS_CACHE_PUT(f, sc->gmst.sin_theta);
+    PASS_CACHE_PUT(f, sc->gmst.cos_theta);
+    PASS_CACHE_PUT(f, sc->gmst.sin_step);
+    PASS_CACHE_PUT(f, sc->gmst.cos_step);
+    PASS_CACHE_PUT(f, sc->gmst.since_sync);
+    for (int k = 0; k < num_observers; k++)
     {
-        Satellite *current_sat = sat ? sat : &satellites[s];
-        if (!current_sat || !current_sat->is_active)
-            continue;
+        const PassScanLook *lk = &sc->looks[k];
+        PASS_CACHE_PUT(f, lk->prev_el);
+        pass_cache_put_flag(f, lk->in_pass);
+        PASS_CACHE_PUT(f, lk->aos_epoch);
+        PASS_CACHE_PUT(f, lk->max_el_epoch);
+        PASS_CACHE_PUT(f, lk->max_el);
+    }
 
-        double t = start_epoch;
-        double t_unix = get_unix_from_epoch(t);
-        double gmst = epoch_to_gmst(t);
-        double az, el;
+    PASS_CACHE_PUT(f, tr->passes.count);
+    for (int j = 0; j < tr->passes.count; j++)
+    {
+        const SatPass *p = &tr->passes.items[j];
+        PASS_CACHE_PUT(f, p->observer);
+        PASS_CACHE_PUT(f, p->aos_epoch);
+        PASS_CACHE_PUT(f, p->los_epoch);
+        PASS_CACHE_PUT(f, p->max_el_epoch);
+        PASS_CACHE_PUT(f, p->max_el);
+    }
+}
 
-        get_az_el(calculate_position(current_sat, t_unix), gmst, home_location.lat, home_location.lon, home_location.alt, &az, &el);
+/* false on a short read or anything out of range. e is zeroed first, its pass list may be left allocated */
+static bool pass_cache_get_entry(FILE *f, PassCacheEntry *e, int num_observers)
+{
+    *e = (PassCacheEntry){0};
+    PassTrack *tr = &e->track;
+    PassScan *sc = &tr->scan;
+    if (fread(e->norad_id, 1, sizeof(e->norad_id), f) != sizeof(e->norad_id) || !PASS_CACHE_GET(f, e->epoch_days))
+        return false;
 
-        /* back up if happens to already be in a pass to catch the true start */
-        if (el > 0)
-        {
-            for (int i = 0; i < 30 && el > 0; i++)
-            {
-                t -= (1.0 / 1440.0);
-                t_unix = get_unix_from_epoch(t);
-                gmst = epoch_to_gmst(t);
-                get_az_el(calculate_position(current_sat, t_unix), gmst, home_location.lat, home_location.lon, home_location.alt, &az, &el);
-            }
-        }
+    if (!PASS_CACHE_GET(f, tr->until) || !pass_cache_get_flag(f, &tr->started) || !pass_cache_get_flag(f, &tr->checked) || !PASS_CACHE_GET(f, tr->open))
+        return false;
 
-        bool in_pass = false;
-        SatPass current_pass = {0};
-        current_pass.sat = current_sat;
+    if (!PASS_CACHE_GET(f, sc->from) || !PASS_CACHE_GET(f, sc->start) || !PASS_CACHE_GET(f, sc->step) || !PASS_CACHE_GET(f, sc->step_idx) ||
+        !PASS_CACHE_GET(f, sc->t) || !PASS_CACHE_GET(f, sc->gmst.epoch) || !PASS_CACHE_GET(f, sc->gmst.step_days) || !PASS_CACHE_GET(f, sc->gmst.step_deg) ||
+        !PASS_CACHE_GET(f, sc->gmst.gmst_deg) || !PASS_CACHE_GET(f, sc->gmst.sin_theta) || !PASS_CACHE_GET(f, sc->gmst.cos_theta) ||
+        !PASS_CACHE_GET(f, sc->gmst.sin_step) || !PASS_CACHE_GET(f, sc->gmst.cos_step) || !PASS_CACHE_GET(f, sc->gmst.since_sync))
+        return false;
+    if (sc->step_idx < 0 || (tr->started && !(sc->step > 0.0)))
+        return false;
+    for (int k = 0; k < num_observers; k++)
+    {
+        PassScanLook *lk = &sc->looks[k];
+        if (!PASS_CACHE_GET(f, lk->prev_el) || !pass_cache_get_flag(f, &lk->in_pass) || !PASS_CACHE_GET(f, lk->aos_epoch) ||
+            !PASS_CACHE_GET(f, lk->max_el_epoch) || !PASS_CACHE_GET(f, lk->max_el))
+            return false;
+    }
 
-        int steps = (max_days * 1440) / (coarse_step * 1440.0);
-        for (int i = 0; i < steps && num_passes < MAX_PASSES; i++)
-        {
-            t_unix = get_unix_from_epoch(t);
-            gmst = epoch_to_gmst(t);
-            get_az_el(calculate_position(current_sat, t_unix), gmst, home_location.lat, home_location.lon, home_location.alt, &az, &el);
+    int n;
+    if (!PASS_CACHE_GET(f, n) || n < 0 || n > PASS_CACHE_MAX_TRACK_PASSES || tr->open < 0 || tr->open > n)
+        return false;
+    for (int j = 0; j < n; j++)
+    {
+        SatPass p = {0};
+        if (!PASS_CACHE_GET(f, p.observer) || !PASS_CACHE_GET(f, p.aos_epoch) || !PASS_CACHE_GET(f, p.los_epoch) || !PASS_CACHE_GET(f, p.max_el_epoch) ||
+            !PASS_CACHE_GET(f, p.max_el))
+            return false;
+        if (p.observer < 0 || p.observer >= num_observers || !pass_list_push(&tr->passes, &p))
+            return false;
+    }
+    return true;
+}
 
-            if (el >= 0.0)
-            {
-                if (!in_pass)
-                {
-                    in_pass = true;
-                    /* binary search to find exact AOS because stepping by 1min is too crunchy for radio work */
-                    double t_low = t - coarse_step;
-                    double t_high = t;
-                    for (int b = 0; b < 10; b++)
-                    {
-                        double t_mid = (t_low + t_high) / 2.0;
-                        double mid_unix = get_unix_from_epoch(t_mid);
-                        double mid_gmst = epoch_to_gmst(t_mid);
-                        double mid_az, mid_el;
-                        get_az_el(calculate_position(current_sat, mid_unix), mid_gmst, home_location.lat, home_location.lon, home_location.alt, &mid_az, &mid_el);
-                        if (mid_el >= 0.0)
-                            t_high = t_mid;
-                        else
-                            t_low = t_mid;
-                    }
+bool pass_cache_save(const char *filename)
+{
+    if (!pass_cache.dirty)
+        return true;
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return false;
+    int header[3] = {PASS_CACHE_MAGIC, PASS_CACHE_VERSION, pass_cache.num_observers};
+    fwrite(header, sizeof(header), 1, f);
+    for (int k = 0; k < pass_cache.num_observers; k++)
+    {
+        PASS_CACHE_PUT(f, pass_cache.observers[k].lat);
+        PASS_CACHE_PUT(f, pass_cache.observers[k].lon);
+        PASS_CACHE_PUT(f, pass_cache.observers[k].alt);
+    }
+    PASS_CACHE_PUT(f, pass_cache.min_el);
+    PASS_CACHE_PUT(f, pass_cache.days);
+    PASS_CACHE_PUT(f, pass_cache.start_epoch);
+    PASS_CACHE_PUT(f, pass_cache.count);
+    for (int i = 0; i < pass_cache.count; i++)
+        pass_cache_put_entry(f, &pass_cache.entries[i], pass_cache.num_observers);
+    bool ok = !ferror(f);
+    fclose(f);
+    if (ok)
+        pass_cache.dirty = false;
+    return ok;
+}
 
-                    current_pass.aos_epoch = t_high;
-                    current_pass.max_el = el;
-                    current_pass.max_el_epoch = t;
-                }
-                if (el > current_pass.max_el)
-                {
-                    current_pass.max_el = el;
-                    current_pass.max_el_epoch = t;
-                }
-            }
-            else
-            {
-                if (in_pass)
-                {
-                    in_pass = false;
-                    /* binary search to find exact LOS crossing */
-                    double t_low = t - coarse_step;
-                    double t_high = t;
-                    for (int b = 0; b < 10; b++)
-                    {
-                        double t_mid = (t_low + t_high) / 2.0;
-                        double mid_unix = get_unix_from_epoch(t_mid);
-                        double mid_gmst = epoch_to_gmst(t_mid);
-                        double mid_az, mid_el;
-                        get_az_el(calculate_position(current_sat, mid_unix), mid_gmst, home_location.lat, home_location.lon, home_location.alt, &mid_az, &mid_el);
-                        if (mid_el < 0.0)
-                            t_high = t_mid;
-                        else
-                            t_low = t_mid;
-                    }
+/* all or nothing: a file from another version, or one that's cut short or out of range anywhere, leaves the
+   cache empty */
+bool pass_cache_load(const char *filename)
+{
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return false;
+    pass_cache_clear();
 
-                    current_pass.los_epoch = t_low;
-
-                    current_pass.num_pts = 0;
-                    double step = (current_pass.los_epoch - current_pass.aos_epoch) / 399.0;
-                    if (step > 0)
-                    {
-                        current_pass.max_el = -90.0f; /* reset to find true max during high-res pass */
-                        for (int k = 0; k < 400; k++)
-                        {
-                            double pt = current_pass.aos_epoch + k * step;
-                            double pt_unix = get_unix_from_epoch(pt);
-                            double p_gmst = epoch_to_gmst(pt);
-                            double p_az, p_el;
-                            get_az_el(calculate_position(current_sat, pt_unix), p_gmst, home_location.lat, home_location.lon, home_location.alt, &p_az, &p_el);
-                            current_pass.path_pts[current_pass.num_pts++] = (Vector2){(float)p_az, (float)p_el};
-                            
-                            /* ensure max elevation is pinpointed */
-                            if (p_el > current_pass.max_el)
-                            {
-                                current_pass.max_el = (float)p_el;
-                                current_pass.max_el_epoch = pt;
-                            }
-                        }
-                    }
-                    passes[num_passes++] = current_pass;
-                    current_pass = (SatPass){0};
-                    current_pass.sat = current_sat;
-                }
-            }
-            t += coarse_step;
+    int header[3];
+    bool ok = fread(header, sizeof(header), 1, f) == 1 && header[0] == PASS_CACHE_MAGIC && header[1] == PASS_CACHE_VERSION && header[2] > 0 &&
+              header[2] <= PASS_MAX_OBSERVERS;
+    int count = 0;
+    if (ok)
+    {
+        pass_cache.num_observers = header[2];
+        for (int k = 0; k < pass_cache.num_observers && ok; k++)
+        {
+            pass_cache.observers[k] = (Marker){0};
+            ok = PASS_CACHE_GET(f, pass_cache.observers[k].lat) && PASS_CACHE_GET(f, pass_cache.observers[k].lon) &&
+                 PASS_CACHE_GET(f, pass_cache.observers[k].alt);
         }
+        ok = ok && PASS_CACHE_GET(f, pass_cache.min_el) && PASS_CACHE_GET(f, pass_cache.days) && PASS_CACHE_GET(f, pass_cache.start_epoch) &&
+             PASS_CACHE_GET(f, count) && count >= 0 && count <= PASS_CACHE_MAX_ENTRIES && pass_cache.days > 0.0 && pass_cache.days <= PASS_MAX_HORIZON_DAYS;
+    }
+    if (ok && count > 0)
+        ok = (pass_cache.entries = (PassCacheEntry *)malloc(count * sizeof(PassCacheEntry))) != NULL;
 
-        if (in_pass && num_passes < MAX_PASSES)
+    while (ok && pass_cache.count < count)
+    {
+        PassCacheEntry *e = &pass_cache.entries[pass_cache.count];
+        if (!pass_cache_get_entry(f, e, pass_cache.num_observers))
         {
-            current_pass.los_epoch = t;
-            current_pass.num_pts = 0;
-            double step = (current_pass.los_epoch - current_pass.aos_epoch) / 399.0;
-            if (step > 0)
-            {
-                current_pass.max_el = -90.0f;
-                for (int k = 0; k < 400; k++)
-                {
-                    double pt = current_pass.aos_epoch + k * step;
-                    double pt_unix = get_unix_from_epoch(pt);
-                    double p_gmst = epoch_to_gmst(pt);
-                    double p_az, p_el;
-                    get_az_el(calculate_position(current_sat, pt_unix), p_gmst, home_location.lat, home_location.lon, home_location.alt, &p_az, &p_el);
-                    current_pass.path_pts[current_pass.num_pts++] = (Vector2){(float)p_az, (float)p_el};
-                    
-                    if (p_el > current_pass.max_el)
-                    {
-                        current_pass.max_el = (float)p_el;
-                        current_pass.max_el_epoch = pt;
-                    }
-                }
-            }
-            passes[num_passes++] = current_pass;
+            pass_list_free(&e->track.passes);
+            break;
         }
+        pass_cache.count++;
     }
+    fclose(f);
+    if (pass_cache.count < count)
+        pass_cache_clear();
+    if (pass_cache.count > 1)
+        qsort(pass_cache.entries, pass_cache.count, sizeof(PassCacheEntry), compare_cache_entries);  // bsearch relies on it, don't trust the file
+    pass_cache.dirty = false;
+    return pass_cache.count > 0;
+}
+
+#undef PASS_CACHE_PUT
+#undef PASS_CACHE_GET
 
-    /* make sure the list actually makes sense chronologically */
-    /* Sort overall passes generated by timeframe chronological arrival order */
-    qsort(passes, num_passes, sizeof(SatPass), compare_passes);
+/* the whole search in one go */
+void CalculatePasses(Satellite *sat, double start_epoch, double days, float min_el)
+{
+    PassSearch ps = {0};
+    if (!pass_search_begin(&ps, sat, start_epoch, days, min_el, NULL, 0))
+        return;
+    while (!pass_search_step(&ps, INFINITY))
+        ;
+    pass_search_finish(&ps);
 }
 
 /* formats the internal epoch into a HH:MM:SS string for quick glancing */
@@ -654,8 +3151,7 @@ void epoch_to_time_str(double epoch, char *str)
 /* i truly do hope this doesnt drift or something its so eyeballed istg */
 Vector3 calculate_sun_position(double current_time_days)
 {
-    double unix_time = get_unix_from_epoch(current_time_days);
-    double jd = (unix_time / 86400.0) + 2440587.5;
+    double jd = current_time_days + UNIX_EPOCH_JD;
     double n = jd - 2451545.0;
 
     double L = fmod(280.460 + 0.9856474 * n, 360.0);
@@ -698,8 +3194,7 @@ bool is_sat_eclipsed(Vector3 pos_km, Vector3 sun_dir_norm)
 /* HYPER-ENHANCED MOON FUNCTION OMEGABLOCK BING BONG MK.3 PRO [OVERCLOCKED & OPTIMIZED] */
 Vector3 calculate_moon_position(double current_time_days)
 {
-    double unix_time = get_unix_from_epoch(current_time_days);
-    double jd = (unix_time / 86400.0) + 2440587.5;
+    double jd = current_time_days + UNIX_EPOCH_JD;
     double D_days = jd - 2451545.0; /* days since J2000 */
 
     /* some arguments */
@@ -770,14 +3265,46 @@ double get_sat_range(Satellite *sat, double epoch, Marker obs)
     return sqrt(dx * dx + dy * dy + dz * dz);
 }
 
+/* range and range rate off one sgp4 call: both vectors into ECEF, the frame rotation taken out of the
+   velocity, then projected on the line of sight. km and km/s, positive = moving away */
+double get_sat_range_rate(Satellite *sat, double epoch, Marker obs, double *out_range)
+{
+    double t_unix = get_unix_from_epoch(epoch);
+    double theta = epoch_to_gmst(epoch) * DEG2RAD;
+
+    double r[3], v[3];
+    calculate_state_vector(sat, t_unix, r, v);
+
+    double cos_t = cos(theta);
+    double sin_t = sin(theta);
+
+    double s_x = r[0] * cos_t + r[1] * sin_t;
+    double s_y = -r[0] * sin_t + r[1] * cos_t;
+    double s_z = r[2];
+
+    double v_x = v[0] * cos_t + v[1] * sin_t + EARTH_ROTATION_RATE * s_y;
+    double v_y = -v[0] * sin_t + v[1] * cos_t - EARTH_ROTATION_RATE * s_x;
+    double v_z = v[2];
+
+    double o_x, o_y, o_z;
+    geodetic_to_ecef(obs.lat, obs.lon, obs.alt, &o_x, &o_y, &o_z);
+
+    double dx = s_x - o_x;
+    double dy = s_y - o_y;
+    double dz = s_z - o_z;
+    double range = sqrt(dx * dx + dy * dy + dz * dz);
+
+    if (out_range)
+        *out_range = range;
+    if (range == 0.0)
+        return 0.0;
+    return (dx * v_x + dy * v_y + dz * v_z) / range;
+}
+
 /* shifts the frequency based on velocity relative to the observer; essential for tuning */
 double calculate_doppler_freq(Satellite *sat, double epoch, Marker obs, double base_freq)
 {
-    /* line-of-sight range */
-    double dt = 0.1 / 86400.0; /* 0.1 seconds step */
-    double r1 = get_sat_range(sat, epoch - dt, obs);
-    double r2 = get_sat_range(sat, epoch + dt, obs);
-    double range_rate = (r2 - r1) / 0.2; /* km/s */
+    double range_rate = get_sat_range_rate(sat, epoch, obs, NULL); /* km/s */
 
     double c = 299792.458; /* in km/s */
     return base_freq * (c / (c + range_rate));
@@ -788,7 +3315,7 @@ void draw_satellite_orbit_arch(Satellite *sat, double current_epoch, double gmst
                                Vector2 scope_center, float scope_radius, float scope_az, float scope_el, 
                                float scope_beam, Color orbit_color)
 {
-    if (!sat || !sat->is_active) return;
+    if (!sat || !sat_active[sat->id]) return;
     
     // calculate how long it takes this space junk to go around the planet
     double period_days = (2.0 * PI / sat->mean_motion) / 86400.0;
@@ -800,23 +3327,23 @@ void draw_satellite_orbit_arch(Satellite *sat, double current_epoch, double gmst
     float c_az_rad = scope_az * DEG2RAD;
     float c_el_rad = scope_el * DEG2RAD;
     
-    // get observer's position in ECI
-    double ecef_x, ecef_y, ecef_z;
-    geodetic_to_ecef(obs.lat, obs.lon + gmst_deg, obs.alt, &ecef_x, &ecef_y, &ecef_z);
-    Vector3 O_eci = { (float)ecef_x, (float)ecef_z, (float)-ecef_y };
+    // generate all the points that make up the orbit path, then convert to azimuth/elevation in one go
+    Vector3 arch_pos[361];
+    double arch_az[361], arch_el[361];
+    for (int i = 0; i <= num_points; i++) {
+        double t = current_epoch + (i * time_step);
+        arch_pos[i] = calculate_position(sat, get_unix_from_epoch(t));
+    }
+    ObserverFrame of;
+    observer_frame_init(&of, obs.lat, obs.lon, obs.alt);
+    double theta = gmst_deg * DEG2RAD;
+    observer_look_batch(&of, arch_pos, num_points + 1, sin(theta), cos(theta), arch_az, arch_el);
     
     Vector2 prev_point = {0};
     bool has_prev_point = false;
     
-    // generate all the points that make up the orbit path
     for (int i = 0; i <= num_points; i++) {
-        double t = current_epoch + (i * time_step);
-        double t_unix = get_unix_from_epoch(t);
-        Vector3 sat_pos = calculate_position(sat, t_unix);
-        
-        // convert to azimuth/elevation to know where to draw it
-        double s_az, s_el;
-        get_az_el(sat_pos, gmst_deg, obs.lat, obs.lon, obs.alt, &s_az, &s_el);
+        double s_az = arch_az[i], s_el = arch_el[i];
         
         // don't draw parts of the orbit that are below the horizon
         if (s_el < 0) {
@@ -3,29 +3,179 @@
 
 #include "types.h"
 
-#define MAX_PASSES 1000
 typedef struct
 {
     Satellite *sat;
+    int observer;  // index into pass_observers[]
     double aos_epoch;
     double los_epoch;
     double max_el_epoch;
     float max_el;
-    Vector2 path_pts[400];
-    int num_pts;
 } SatPass;
 
-extern SatPass passes[MAX_PASSES];
+extern SatPass *passes;  // front half of a double buffer, see pass_search_publish
+
+#define SKY_TRACK_POINTS 400
+
+/* high-res az/el track across one pass for the polar plot, see pass_sky_track */
+typedef struct
+{
+    Satellite *sat;
+    double aos_epoch;
+    double los_epoch;
+    float lat, lon, alt;  // observer it was made for
+    unsigned int last_used;
+    int num_pts;
+    Vector2 pts[SKY_TRACK_POINTS];  // x = az, y = el, deg
+} SkyTrack;
+
+/* earth rotation across an evenly stepped sweep, see gmst_sweep_next */
+typedef struct
+{
+    double epoch;      // time of the current sample
+    double step_days;
+    double step_deg;
+    double gmst_deg;
+    double sin_theta;  // of gmst_deg, for the ECI -> ECEF rotation
+    double cos_theta;
+    double sin_step;
+    double cos_step;
+    int since_sync;
+} GmstSweep;
+
+/* everything about an observer that doesn't change with time, see observer_frame_init */
+typedef struct
+{
+    float lat, lon, alt;  // what it was built from
+    double ecef[3];       // km
+    double enu[3][3];     // rows: east, north, up unit vectors in ECEF
+} ObserverFrame;
+
+/* growable list of passes */
+typedef struct
+{
+    SatPass *items;
+    int count;
+    int capacity;
+} PassList;
+
+/* home plus up to this many minus one markers get searched together, see pass_search_begin */
+#define PASS_MAX_OBSERVERS 8
+
+/* somewhere passes get predicted for */
+typedef struct
+{
+    Marker site;
+    ObserverFrame frame;
+} PassObserver;
+
+/* observers the passes[] entries point into, published along with them */
+extern PassObserver pass_observers[PASS_MAX_OBSERVERS];
+extern int num_pass_observers;
+
+/* one observer's side of a scan */
+typedef struct
+{
+    double prev_el;  // elevation at the last coarse step, brackets the next crossing
+    bool in_pass;
+    double aos_epoch;     // of the pass in progress
+    double max_el_epoch;  // best coarse sample so far
+    float max_el;
+} PassScanLook;
+
+/* where the coarse search for one sat is at. every step propagates once and looks from every observer */
+typedef struct
+{
+    Satellite *sat;
+    double from;     // where it was asked to start; it may back up to catch a pass already going somewhere
+    double start;    // time of step 0
+    double step;     // coarse step, days. per sat, see pass_coarse_step
+    int step_idx;    // next coarse step
+    double t;
+    GmstSweep gmst;  // follows t
+    PassScanLook looks[PASS_MAX_OBSERVERS];
+} PassScan;
+
+/* everything known about one sat's passes, kept between searches so the window can slide along */
+typedef struct
+{
+    PassList passes;  // in order of LOS, give or take a coarse step between observers
+    int published;    // the first this many are in passes[] already
+    double retracted_aos[PASS_MAX_OBSERVERS];  // published cut-off pass that got taken back since, 0 = none
+    PassScan scan;    // parked wherever the search got to
+    double until;     // searched or ruled out up to here
+    bool started;     // scan is set up; false = (re)start it at until when there's a chance of a pass
+    bool checked;     // the stretch being scanned got past pass_possible already
+    int open;         // the last this many in passes got cut off by the window end and are still being followed
+} PassTrack;
+
+#define PASS_MAX_HORIZON_DAYS 28.0  // longest window pass_search_begin takes
+
+/* resumable pass search, see pass_search_step. it keeps its state once done, so pass_search_slide and
+   pass_search_refresh_sat only have to redo the bits that changed */
+typedef struct
+{
+    Satellite *sat;  // NULL = every active sat, searched in parallel batches
+    double start_epoch;
+    double end_epoch;
+    double days;     // window length
+    float min_el;    // every pass reaching this high is guaranteed to be found, lower ones may be missed
+    PassObserver observers[PASS_MAX_OBSERVERS];  // [0] is home
+    int num_observers;
+    PassTrack *tracks;  // by satellites[] index, or just [0] for a single sat
+    int track_capacity;
+    int sat_idx;     // tracks below this have been taken on
+    int next;        // next track to bring up to end_epoch
+    double ms_per_sat;  // all-sats only: running estimate for sizing batches against the deadline
+    int pass_count;  // across all tracks
+    bool changed;    // something new for pass_search_publish
+    bool rebuild;    // start passes[] over from the tracks instead of merging into it
+    int candidates;  // active sats looked at so far
+    int rejected;    // of those, ruled out by pass_possible without propagating
+} PassSearch;
+
+/* resumable catalog load, see tle_loader_step */
+typedef struct
+{
+    FILE *file;
+    long size;
+    bool activate;  // false = new sats start out unchecked
+} TleLoader;
 extern int num_passes;
 extern Satellite *last_pass_calc_sat;
 
+/* per-partition propagation numbers for the statistics overlay */
+typedef struct
+{
+    int near_count;
+    int deep_count;
+    int near_active;
+    int deep_active;
+    double near_ms;
+    double deep_ms;
+    int orbit_points;           // orbit cache points propagated this frame
+    int orbit_backlog;          // stale orbit caches left over when the builder's frame budget ran out
+    int ephem_windows;          // active sats currently served from a chebyshev window
+    float ephem_max_error_km;   // worst fit residual among those windows
+    int pass_candidates;        // active sats the last pass search got through
+    int pass_rejected;          // of those, skipped by the visibility prefilter
+} PropagationStats;
+
+extern PropagationStats prop_stats;
+
 double get_current_real_time_epoch(void);
 double epoch_to_gmst(double epoch);
+void gmst_sweep_begin(GmstSweep *sw, double start_epoch, double step_days);
+void gmst_sweep_next(GmstSweep *sw);
 void epoch_to_datetime_str(double epoch, char *buffer);
 void load_tle_data(const char *filename);
+bool tle_loader_open(TleLoader *ld, const char *filename, bool activate);
+bool tle_loader_step(TleLoader *ld, double deadline_ms);
+float tle_loader_progress(const TleLoader *ld);
+void tle_loader_close(TleLoader *ld);
 void load_manual_tles(AppConfig *config);
-double normalize_epoch(double epoch);
 double get_unix_from_epoch(double epoch);
+double unix_to_epoch(double target_unix);
 
 // orbit math stuff
 Vector3 calculate_sun_position(double current_time_days);
@@ -33,19 +183,57 @@ bool is_sat_eclipsed(Vector3 pos_km, Vector3 sun_dir_norm);
 void get_map_coordinates(Vector3 pos, double gmst_deg, float earth_offset, float map_w, float map_h, float *out_x,
                          float *out_y);
 Vector3 calculate_position(Satellite *sat, double current_unix);
+void calculate_state_vector(Satellite *sat, double current_unix, double r[3], double v[3]);
+void free_deep_space_checkpoints(DeepSpaceCheckpoints *ck);
+void prepare_batch_propagation(void);
+int get_near_earth_count(void);
+int get_deep_space_count(void);
+int get_deep_space_active_count(void);
+void propagate_near_earth(double current_unix, int start, int end);
+void propagate_deep_space(double current_unix, int start, int end);
+void start_ephemeris_builder(void);
+void stop_ephemeris_builder(void);
+void update_ephemeris_clock(double current_unix, float tolerance_km);
 Vector3 calculate_moon_position(double current_time_days);
 void get_apsis_2d(Satellite *sat, double current_time, bool is_apoapsis, double gmst_deg, float earth_offset,
                   float map_w, float map_h, Vector2 *out);
 void get_apsis_times(Satellite *sat, double current_time, double *out_peri_unix, double *out_apo_unix);
 void geodetic_to_ecef(double lat_deg, double lon_deg, double alt_m, double *ox, double *oy, double *oz);
 void get_az_el(Vector3 eci_pos, double gmst_deg, float obs_lat, float obs_lon, float obs_alt, double *az, double *el);
-void CalculatePasses(Satellite *sat, double start_epoch);
+void get_az_el_rot(Vector3 eci_pos, double sin_theta, double cos_theta, float obs_lat, float obs_lon, float obs_alt, double *az, double *el);
+void observer_frame_init(ObserverFrame *of, float lat, float lon, float alt);
+const ObserverFrame *get_home_frame(void);
+void observer_look(const ObserverFrame *of, Vector3 eci_pos, double sin_theta, double cos_theta, double *az, double *el);
+void observer_look_batch(const ObserverFrame *of, const Vector3 *eci_pos, int count, double sin_theta, double cos_theta, double *az, double *el);
+void CalculatePasses(Satellite *sat, double start_epoch, double days, float min_el);
+bool pass_search_begin(PassSearch *ps, Satellite *sat, double start_epoch, double days, float min_el, const Marker *sites, int num_sites);
+bool pass_search_step(PassSearch *ps, double deadline_ms);
+float pass_search_progress(const PassSearch *ps);
+bool pass_search_slide(PassSearch *ps, double now);
+bool pass_search_refresh_sat(PassSearch *ps, Satellite *sat);
+bool pass_search_publish(PassSearch *ps);
+void pass_search_finish(PassSearch *ps);
+void pass_search_abort(PassSearch *ps);
+const SkyTrack *pass_sky_track(const SatPass *p);
+void pass_cache_store(const PassSearch *ps);
+bool pass_cache_save(const char *filename);
+bool pass_cache_load(const char *filename);
 void epoch_to_time_str(double epoch, char *str);
-void update_orbit_cache(Satellite *sat, double current_epoch);
-bool is_orbit_cache_valid(Satellite *sat, Vector3 current_pos, float drift_threshold_km);
+/* mark_orbit_drawn priorities: on-screen orbits pass their projected size (0..1], off-screen ones 0 */
+#define ORBIT_PRIORITY_FOCUSED 2.0f  // selected/hovered, ahead of everything on screen
+
+void start_orbit_cache_builder(void);
+void stop_orbit_cache_builder(void);
+void release_orbit_cache(Satellite *sat);
+void mark_orbit_drawn(Satellite *sat, float priority);
+bool is_orbit_wanted(Satellite *sat);
+const OrbitCache *get_orbit_cache(Satellite *sat);
+void begin_orbit_cache_frame(double current_unix, int budget_mb, float frame_budget_ms);
+size_t get_orbit_cache_pool_bytes(void);
 int calculate_orbit_cache_resolution(double eccentricity, int active_sat_count, int total_sat_count);
 
 double get_sat_range(Satellite *sat, double epoch, Marker obs);
+double get_sat_range_rate(Satellite *sat, double epoch, Marker obs, double *out_range);
 double calculate_doppler_freq(Satellite *sat, double epoch, Marker obs, double base_freq);
 void draw_satellite_orbit_arch(Satellite *sat, double current_epoch, double gmst_deg, Marker obs, 
                                Vector2 scope_center, float scope_radius, float scope_az, float scope_el, 
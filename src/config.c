@@ -70,6 +70,11 @@ void LoadAppConfig(const char *filename, AppConfig *config)
     config->show_first_run_dialog = false; //default
     config->hint_vsync = true;       // default
     config->custom_tle_source_count = 0;
+    config->worker_threads = 0;       // default, auto
+    config->ephemeris_tolerance_km = 0.01f; // default, 10 m
+    config->orbit_cache_budget_mb = 64;     // default
+    config->orbit_cache_frame_ms = 8.0f;    // default
+    config->pass_horizon_days = 3.0f;       // default
 
     if (FileExists(filename))
     {
@@ -118,9 +123,14 @@ void LoadAppConfig(const char *filename, AppConfig *config)
             PARSE_INT("window_width", window_width);
             PARSE_INT("window_height", window_height);
             PARSE_INT("target_fps", target_fps);
+            PARSE_INT("worker_threads", worker_threads);
+            PARSE_INT("orbit_cache_budget_mb", orbit_cache_budget_mb);
+            PARSE_FLOAT("orbit_cache_frame_ms", orbit_cache_frame_ms);
+            PARSE_FLOAT("pass_horizon_days", pass_horizon_days);
             PARSE_FLOAT("ui_scale", ui_scale);
             PARSE_FLOAT("earth_rotation_offset", earth_rotation_offset);
             PARSE_FLOAT("orbits_to_draw", orbits_to_draw);
+            PARSE_FLOAT("ephemeris_tolerance_km", ephemeris_tolerance_km);
 
             config->show_clouds = ParseJsonBool(text, "show_clouds", config->show_clouds);
             config->show_night_lights = ParseJsonBool(text, "show_night_lights", config->show_night_lights);
@@ -264,6 +274,7 @@ void LoadAppConfig(const char *filename, AppConfig *config)
                     char *lat_ptr = strstr(m_ptr, "\"lat\"");
                     char *lon_ptr = strstr(m_ptr, "\"lon\"");
                     char *alt_ptr = strstr(m_ptr, "\"alt\"");
+                    char *passes_ptr = strstr(m_ptr, "\"passes\"");
 
                     // alt_ptr is optional now
                     if (name_ptr && name_ptr < obj_end && lat_ptr && lat_ptr < obj_end && lon_ptr && lon_ptr < obj_end)
@@ -293,6 +304,14 @@ void LoadAppConfig(const char *filename, AppConfig *config)
                                 sscanf(colon_alt + 1, "%f", &markers[marker_count].alt);
                         }
 
+                        markers[marker_count].passes = false;
+                        if (passes_ptr && passes_ptr < obj_end)
+                        {
+                            char *colon_passes = strchr(passes_ptr, ':');
+                            if (colon_passes && colon_passes < obj_end)
+                                markers[marker_count].passes = strncmp(colon_passes + 1 + strspn(colon_passes + 1, " "), "true", 4) == 0;
+                        }
+
                         marker_count++;
                     }
                     m_ptr = obj_end + 1;
@@ -328,6 +347,7 @@ void LoadAppConfig(const char *filename, AppConfig *config)
         markers[0].lat = 28.3922f;
         markers[0].lon = -80.6077f;
         markers[0].alt = 0.0f;
+        markers[0].passes = false;
 
         config->show_first_run_dialog = true;
 
@@ -404,9 +424,14 @@ void SaveAppConfig(const char *filename, AppConfig *config)
     fprintf(file, "    \"window_width\": %d,\n", config->window_width);
     fprintf(file, "    \"window_height\": %d,\n", config->window_height);
     fprintf(file, "    \"target_fps\": %d,\n", config->target_fps);
+    fprintf(file, "    \"worker_threads\": %d,\n", config->worker_threads);
+    fprintf(file, "    \"orbit_cache_budget_mb\": %d,\n", config->orbit_cache_budget_mb);
+    fprintf(file, "    \"orbit_cache_frame_ms\": %.2f,\n", config->orbit_cache_frame_ms);
+    fprintf(file, "    \"pass_horizon_days\": %.2f,\n", config->pass_horizon_days);
     fprintf(file, "    \"ui_scale\": %.2f,\n", config->ui_scale);
     fprintf(file, "    \"earth_rotation_offset\": %.2f,\n", config->earth_rotation_offset);
     fprintf(file, "    \"orbits_to_draw\": %.2f,\n", config->orbits_to_draw);
+    fprintf(file, "    \"ephemeris_tolerance_km\": %.4f,\n", config->ephemeris_tolerance_km);
     fprintf(file, "    \"show_clouds\": %s,\n", config->show_clouds ? "true" : "false");
     fprintf(file, "    \"show_night_lights\": %s,\n", config->show_night_lights ? "true" : "false");
     fprintf(file, "    \"show_markers\": %s,\n", config->show_markers ? "true" : "false");
@@ -443,7 +468,7 @@ void SaveAppConfig(const char *filename, AppConfig *config)
     fprintf(file, "    \"markers\": [\n");
     for (int i = 0; i < marker_count; i++)
     {
-        fprintf(file, "    {\"name\": \"%s\", \"lat\": %.4f, \"lon\": %.4f, \"alt\": %.4f}%s\n", markers[i].name, markers[i].lat, markers[i].lon, markers[i].alt, (i == marker_count - 1) ? "" : ",");
+        fprintf(file, "    {\"name\": \"%s\", \"lat\": %.4f, \"lon\": %.4f, \"alt\": %.4f, \"passes\": %s}%s\n", markers[i].name, markers[i].lat, markers[i].lon, markers[i].alt, markers[i].passes ? "true" : "false", (i == marker_count - 1) ? "" : ",");
     }
     fprintf(file, "    ]\n");
     fprintf(file, "}\n");
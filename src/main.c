@@ -19,6 +19,8 @@ static const char* GetAssetPath(const char* theme, const char* filename) {
 #include "types.h"
 #include "ui.h"
 #include "rotator.h"
+#include "workers.h"
+#include "tasks.h"
 
 /* * shaders for day/night transition
  * uses dot product between surface normal and sun direction
@@ -272,7 +274,10 @@ static AppConfig cfg = {
     .show_slant_range = false,
     .show_scattering = false,
     .hint_vsync = false,
-    .orbit_cache_drift_threshold_km = 50.0f,
+    .ephemeris_tolerance_km = 0.01f,
+    .orbit_cache_budget_mb = 64,
+    .orbit_cache_frame_ms = 8.0f,
+    .pass_horizon_days = 3.0f,
     .bg_color = {0, 0, 0, 255},
     .text_main = {255, 255, 255, 255},
     .theme = "default",
@@ -349,6 +354,41 @@ static Mesh GenEarthMesh(float radius, int slices, int rings)
     return mesh;
 }
 
+/* every orbit is centered on the earth, so how much of the screen one covers only depends on its apoapsis;
+   the camera half gets worked out once per frame */
+typedef struct
+{
+    float dist;       // camera to earth center
+    float off_axis;   // angle between the view direction and the earth center
+    float half_fov;
+    float half_diag;  // half the view cone across the screen diagonal
+} OrbitView;
+
+static OrbitView GetOrbitView(Camera3D cam)
+{
+    OrbitView v;
+    Vector3 to_center = Vector3Negate(cam.position);
+    Vector3 forward = Vector3Subtract(cam.target, cam.position);
+    float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+    v.dist = Vector3Length(to_center);
+    v.off_axis = Vector3Angle(forward, to_center);
+    v.half_fov = cam.fovy * 0.5f * DEG2RAD;
+    v.half_diag = atanf(tanf(v.half_fov) * sqrtf(1.0f + aspect * aspect));
+    return v;
+}
+
+/* (0, 1] for an orbit that's on screen, by its angular size; 0 when it's entirely out of view */
+static float GetOrbitScreenSize(const OrbitView *v, Satellite *sat)
+{
+    float r = (float)(sat->semi_major_axis * (1.0 + sat->eccentricity)) / DRAW_SCALE;
+    if (v->dist <= r)
+        return 1.0f;
+    float ang_radius = asinf(r / v->dist);
+    if (v->off_axis - ang_radius > v->half_diag)
+        return 0.0f;
+    return fmaxf(fminf(ang_radius / v->half_fov, 1.0f), 1e-3f);
+}
+
 /* render orbit lines in 3d space */
 static void draw_orbit_3d(Satellite *sat, double current_epoch, bool is_highlighted, float alpha, int step)
 {
@@ -392,15 +432,18 @@ static void draw_orbit_3d(Satellite *sat, double current_epoch, bool is_highligh
     }
     else
     {
-        if (!sat->orbit_cached)
+        const OrbitCache *cache = get_orbit_cache(sat);
+        if (!cache)
             return;
         
-        Vector3 prev_pos = sat->orbit_cache[0];
-        int cache_size = sat->orbit_cache_resolution;
+        /* ring buffer, oldest point first */
+        int cache_size = cache->resolution;
+        int head = (int)(cache->k0 % cache_size);
+        Vector3 prev_pos = cache->points[head];
         
         for (int i = step; i < cache_size; i += step)
         {
-            Vector3 pos = sat->orbit_cache[i];
+            Vector3 pos = cache->points[(head + i) % cache_size];
             DrawLine3D(prev_pos, pos, orbitColor);
             prev_pos = pos;
         }
@@ -408,11 +451,84 @@ static void draw_orbit_3d(Satellite *sat, double current_epoch, bool is_highligh
         // Draw final segment if needed
         if ((cache_size - 1) % step != 0)
         {
-            DrawLine3D(prev_pos, sat->orbit_cache[cache_size - 1], orbitColor);
+            DrawLine3D(prev_pos, cache->points[(head + cache_size - 1) % cache_size], orbitColor);
         }
     }
 }
 
+/* theme reloads go through the task queue one asset per slice. every new texture is loaded before the
+   old one is dropped, so the frames in between just show a bit of both themes */
+#define THEME_RELOAD_STAGES 8
+static int theme_reload_stage = 0;
+
+static Texture2D ReloadThemeTexture(Texture2D old, const char *filename)
+{
+    Texture2D tex = LoadTexture(GetAssetPath(cfg.theme, filename));
+    SetTextureFilter(tex, TEXTURE_FILTER_BILINEAR);
+    UnloadTexture(old);
+    return tex;
+}
+
+static bool ThemeReloadStep(void *state, double deadline_ms, float *progress)
+{
+    int *stage = (int *)state;
+    while (*stage < THEME_RELOAD_STAGES)
+    {
+        switch (*stage)
+        {
+        case 0:
+        {
+            LoadAppConfig("settings.json", &cfg);
+
+            int glyphsCount = 0;
+            int *glyphs = LoadCodepoints(" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~", &glyphsCount);
+            Font font = LoadFontEx(GetAssetPath(cfg.theme, "font.ttf"), 64, glyphs, glyphsCount);
+            GenTextureMipmaps(&font.texture);
+            SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+            UnloadCodepoints(glyphs);
+            UnloadFont(customFont);
+            customFont = font;
+            break;
+        }
+        case 1:
+            earthTexture = ReloadThemeTexture(earthTexture, "earth.png");
+            earthModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = earthTexture;
+            break;
+        case 2:
+            earthNightTexture = ReloadThemeTexture(earthNightTexture, "earth_night.png");
+            earthModel.materials[0].maps[MATERIAL_MAP_EMISSION].texture = earthNightTexture;
+            break;
+        case 3:
+            cloudTexture = ReloadThemeTexture(cloudTexture, "clouds.png");
+            cloudModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = cloudTexture;
+            earthModel.materials[0].maps[MATERIAL_MAP_SPECULAR].texture = cloudTexture;
+            break;
+        case 4:
+            skyboxTexture = ReloadThemeTexture(skyboxTexture, "skybox.png");
+            skyboxModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = skyboxTexture;
+            break;
+        case 5:
+            moonTexture = ReloadThemeTexture(moonTexture, "moon.png");
+            moonModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = moonTexture;
+            break;
+        case 6:
+            satIcon = ReloadThemeTexture(satIcon, "sat_icon.png");
+            markerIcon = ReloadThemeTexture(markerIcon, "marker_icon.png");
+            break;
+        default:
+            periMark = ReloadThemeTexture(periMark, "smallmark.png");
+            apoMark = ReloadThemeTexture(apoMark, "smallmark.png");
+            break;
+        }
+
+        (*stage)++;
+        *progress = (float)*stage / THEME_RELOAD_STAGES;
+        if (*stage < THEME_RELOAD_STAGES && WorkerClockMs() >= deadline_ms)
+            return false;
+    }
+    return true;
+}
+
 /* simple progress bar during init */
 static void DrawLoadingScreen(float progress, const char *message, Texture2D logoTex)
 {
@@ -528,9 +644,46 @@ static bool GetMouseEarthIntersection(Vector2 mouse, bool is_2d, Camera2D cam2d,
     }
 }
 
+/* per-frame job data handed to the worker pool */
+typedef struct
+{
+    double current_epoch;
+    double current_unix;
+} FrameJob;
+
+static void NearEarthJob(void *user, int start, int end)
+{
+    FrameJob *job = (FrameJob *)user;
+    propagate_near_earth(job->current_unix, start, end);
+}
+
+static void DeepSpaceJob(void *user, int start, int end)
+{
+    FrameJob *job = (FrameJob *)user;
+    propagate_deep_space(job->current_unix, start, end);
+}
+
+typedef struct
+{
+    double gmst_deg;
+    float earth_offset;
+    float map_w, map_h;
+} MapJob;
+
+static void MapProjectJob(void *user, int start, int end)
+{
+    MapJob *job = (MapJob *)user;
+    for (int i = start; i < end; i++)
+    {
+        if (sat_active[i])
+            get_map_coordinates(sat_current_pos[i], job->gmst_deg, job->earth_offset, job->map_w, job->map_h, &sat_screen_pos[i].x, &sat_screen_pos[i].y);
+    }
+}
+
 int main(void)
 {
     LoadAppConfig("settings.json", &cfg);
+    WorkerPoolInit(cfg.worker_threads);
 
     /* window setup and msaa */
     SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_WINDOW_RESIZABLE);
@@ -599,6 +752,9 @@ int main(void)
     load_tle_data("data.tle");
     load_manual_tles(&cfg);
     LoadSatSelection(); // restore active satellites
+    LoadPassCache();    // passes from last time, for whichever sats still have the same TLE
+    start_ephemeris_builder();
+    start_orbit_cache_builder();
 
     DrawLoadingScreen(0.25f, "Initializing Textures...", logoTex);
     earthTexture = LoadTexture(GetAssetPath(cfg.theme, "earth.png"));
@@ -754,7 +910,6 @@ int main(void)
     if (!cfg.hint_vsync) SetTargetFPS(cfg.target_fps);
     else SetTargetFPS(0);
     
-    int current_update_idx = 0;
 
     /* main loop */
     while (!WindowShouldClose() && !exit_app)
@@ -762,58 +917,13 @@ int main(void)
         if (cfg.reload_theme)
         {
             cfg.reload_theme = false;
-            
-            UnloadTexture(earthTexture);
-            UnloadTexture(earthNightTexture);
-            UnloadTexture(cloudTexture);
-            UnloadTexture(moonTexture);
-            UnloadTexture(skyboxTexture);
-            UnloadTexture(satIcon);
-            UnloadTexture(markerIcon);
-            UnloadTexture(periMark);
-            UnloadTexture(apoMark);
-            UnloadFont(customFont);
-            
-            LoadAppConfig("settings.json", &cfg);
-            
-            int glyphsCount = 0;
-            int *glyphs = LoadCodepoints(" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~", &glyphsCount);
-            customFont = LoadFontEx(GetAssetPath(cfg.theme, "font.ttf"), 64, glyphs, glyphsCount);
-            GenTextureMipmaps(&customFont.texture);
-            SetTextureFilter(customFont.texture, TEXTURE_FILTER_BILINEAR);
-            UnloadCodepoints(glyphs);
-
-            earthTexture = LoadTexture(GetAssetPath(cfg.theme, "earth.png"));
-            earthNightTexture = LoadTexture(GetAssetPath(cfg.theme, "earth_night.png"));
-            SetTextureFilter(earthTexture, TEXTURE_FILTER_BILINEAR);
-            SetTextureFilter(earthNightTexture, TEXTURE_FILTER_BILINEAR);
-            earthModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = earthTexture;
-            earthModel.materials[0].maps[MATERIAL_MAP_EMISSION].texture = earthNightTexture;
-
-            cloudTexture = LoadTexture(GetAssetPath(cfg.theme, "clouds.png"));
-            SetTextureFilter(cloudTexture, TEXTURE_FILTER_BILINEAR);
-            cloudModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = cloudTexture;
-            earthModel.materials[0].maps[MATERIAL_MAP_SPECULAR].texture = cloudTexture;
-
-            skyboxTexture = LoadTexture(GetAssetPath(cfg.theme, "skybox.png"));
-            SetTextureFilter(skyboxTexture, TEXTURE_FILTER_BILINEAR);
-            skyboxModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = skyboxTexture;
-
-            moonTexture = LoadTexture(GetAssetPath(cfg.theme, "moon.png"));
-            SetTextureFilter(moonTexture, TEXTURE_FILTER_BILINEAR);
-            moonModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = moonTexture;
-
-            satIcon = LoadTexture(GetAssetPath(cfg.theme, "sat_icon.png"));
-            markerIcon = LoadTexture(GetAssetPath(cfg.theme, "marker_icon.png"));
-            periMark = LoadTexture(GetAssetPath(cfg.theme, "smallmark.png"));
-            apoMark = LoadTexture(GetAssetPath(cfg.theme, "smallmark.png"));
-
-            SetTextureFilter(satIcon, TEXTURE_FILTER_BILINEAR);
-            SetTextureFilter(markerIcon, TEXTURE_FILTER_BILINEAR);
-            SetTextureFilter(periMark, TEXTURE_FILTER_BILINEAR);
-            SetTextureFilter(apoMark, TEXTURE_FILTER_BILINEAR);
+            theme_reload_stage = 0;
+            TaskSubmit(TASK_THEME_RELOAD, "Loading theme", ThemeReloadStep, NULL, &theme_reload_stage);
         }
 
+        /* pass predictions, catalog reloads and the like, a slice at a time */
+        RunTasks(TaskFrameBudgetMs(cfg.target_fps));
+
         bool is_typing = IsUITyping();
         bool over_ui = IsMouseOverUI(&cfg);
 
@@ -937,47 +1047,48 @@ int main(void)
 
         /* update time continuously for smooth visual interpolation */
         current_epoch += (GetFrameTime() * time_multiplier) / 86400.0;
-        current_epoch = normalize_epoch(current_epoch);
 
-        /* distance-based invalidation */
-        if (sat_count > 0)
+        double current_unix = get_unix_from_epoch(current_epoch);
+        FrameJob frame_job = {current_epoch, current_unix};
+        update_ephemeris_clock(current_unix, cfg.ephemeris_tolerance_km);
+
+        /* orbit rings are topped up by their own builder thread, all this does is tell it what time it is.
+           it goes by the priorities handed to mark_orbit_drawn while drawing the last frame */
+        prop_stats.orbit_points = 0;
+        begin_orbit_cache_frame(current_unix, cfg.orbit_cache_budget_mb, cfg.orbit_cache_frame_ms);
+
+        /* update current positions of all active sats, one partition at a time across the worker pool */
+        if (hide_unselected && selected_sat != NULL)
         {
-            int updates_per_frame = 20;  // only caches that are invalid get updated
-            for (int i = 0; i < updates_per_frame; i++)
-            {
-                if (satellites[current_update_idx].is_active)
-                {
-                    // Only update if satellite drifted
-                    if (!is_orbit_cache_valid(&satellites[current_update_idx], 
-                                              satellites[current_update_idx].current_pos,
-                                              cfg.orbit_cache_drift_threshold_km))
-                    {
-                        update_orbit_cache(&satellites[current_update_idx], current_epoch);
-                    }
-                }
-                current_update_idx = (current_update_idx + 1) % sat_count;
-            }
+            if (sat_active[selected_sat->id])
+                sat_current_pos[selected_sat->id] = calculate_position(selected_sat, current_unix);
+            prop_stats.near_ms = prop_stats.deep_ms = 0.0;
+        }
+        else
+        {
+            prepare_batch_propagation();
+            double t0 = GetTime();
+            WorkerPoolParallelFor(get_near_earth_count(), 256, NearEarthJob, &frame_job);
+            double t1 = GetTime();
+            WorkerPoolParallelFor(get_deep_space_count(), 16, DeepSpaceJob, &frame_job);
+            prop_stats.near_ms = (t1 - t0) * 1000.0;
+            prop_stats.deep_ms = (GetTime() - t1) * 1000.0;
         }
 
-        double current_unix = get_unix_from_epoch(current_epoch);
-
-        /* update current positions of all active sats */
         int active_render_count = 0;
         for (int i = 0; i < sat_count; i++)
         {
-            if (!satellites[i].is_active)
+            if (!sat_active[i])
                 continue;
-            if (hide_unselected && selected_sat != NULL && &satellites[i] != selected_sat)
+            if (hide_unselected && selected_sat != NULL && satellites[i] != selected_sat)
                 continue;
-            satellites[i].current_pos = calculate_position(&satellites[i], current_unix);
 
-            
             /* spaghetti is good, but orbital spaghetti isn't.
             sooooo if an orbital body ends up below 80% of earths radius, disable it because it's about to meet earth's theoritical singularity and get ejected at speeds higher than light speed. yeeeeeeeet*/
-            if (Vector3Length(satellites[i].current_pos) < EARTH_RADIUS_KM * 0.8f)
+            if (Vector3Length(sat_current_pos[i]) < EARTH_RADIUS_KM * 0.8f)
             {
-                satellites[i].is_active = false;
-                if (selected_sat == &satellites[i])
+                sat_active[i] = false;
+                if (selected_sat == satellites[i])
                     selected_sat = NULL;
                 continue;
             }
@@ -985,6 +1096,15 @@ int main(void)
             active_render_count++;
         }
 
+        /* deep count comes off the partition's index list so the loop above only streams the hot arrays */
+        int deep_active_count;
+        if (hide_unselected && selected_sat != NULL)
+            deep_active_count = (active_render_count > 0 && selected_sat->satrec.method == 'd');
+        else
+            deep_active_count = get_deep_space_active_count();
+        prop_stats.near_active = active_render_count - deep_active_count;
+        prop_stats.deep_active = deep_active_count;
+
         int global_orbit_step = 1;
         if (active_render_count > 13000)
             global_orbit_step = 54;
@@ -1016,6 +1136,13 @@ int main(void)
         epoch_to_datetime_str(current_epoch, datetime_str);
         double gmst_deg = epoch_to_gmst(current_epoch);
 
+        /* 2d view: project every active sat onto the map plane once, picking and drawing both read it */
+        if (is_2d_view)
+        {
+            MapJob map_job = {gmst_deg, cfg.earth_rotation_offset, map_w, map_h};
+            WorkerPoolParallelFor(sat_count, 1024, MapProjectJob, &map_job);
+        }
+
         /* calculate moon orientation and position */
         Vector3 moon_pos_km = calculate_moon_position(current_epoch);
         Vector3 draw_moon_pos = Vector3Scale(moon_pos_km, 1.0f / DRAW_SCALE);
@@ -1084,21 +1211,18 @@ int main(void)
 
                 for (int i = 0; i < sat_count; i++)
                 {
-                    if (!satellites[i].is_active)
+                    if (!sat_active[i])
                         continue;
-                    if (hide_unselected && selected_sat != NULL && &satellites[i] != selected_sat)
+                    if (hide_unselected && selected_sat != NULL && satellites[i] != selected_sat)
                         continue;
 
-                    float mx, my;
-                    get_map_coordinates(satellites[i].current_pos, gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &mx, &my);
-
-                    Vector2 screenPos = GetWorldToScreen2D((Vector2){mx, my}, Camera2DParams);
+                    Vector2 screenPos = GetWorldToScreen2D(sat_screen_pos[i], Camera2DParams);
                     float dist = Vector2Distance(mousePos, screenPos);
 
                     if (dist < hit_radius_pixels && dist < closest_dist)
                     {
                         closest_dist = dist;
-                        hovered_sat = &satellites[i];
+                        hovered_sat = satellites[i];
                     }
                 }
             }
@@ -1135,7 +1259,7 @@ int main(void)
                     float wheel = GetMouseWheelMove();
                     if (wheel != 0)
                     {
-                        if (IsKeyDown(KEY_LEFT_ALT) || IsKeyDown(KEY_RIGHT_ALT) || (is_pov_mode && selected_sat && selected_sat->is_active))
+                        if (IsKeyDown(KEY_LEFT_ALT) || IsKeyDown(KEY_RIGHT_ALT) || (is_pov_mode && selected_sat && sat_active[selected_sat->id]))
                         {
                             Camera3DParams.fovy -= wheel * 5.0f;
                             if (Camera3DParams.fovy < 10.0f) Camera3DParams.fovy = 10.0f;
@@ -1156,7 +1280,7 @@ int main(void)
                 float rot_speed = 1.5f * GetFrameTime();
                 bool moved = false;
                 
-                if (is_pov_mode && selected_sat && selected_sat->is_active)
+                if (is_pov_mode && selected_sat && sat_active[selected_sat->id])
                 {
                     if (IsKeyDown(KEY_RIGHT)) { target_camAngleX -= rot_speed; moved = true; }
                     if (IsKeyDown(KEY_LEFT)) { target_camAngleX += rot_speed; moved = true; }
@@ -1184,12 +1308,12 @@ int main(void)
 
                 for (int i = 0; i < sat_count; i++)
                 {
-                    if (!satellites[i].is_active)
+                    if (!sat_active[i])
                         continue;
-                    if (hide_unselected && selected_sat != NULL && &satellites[i] != selected_sat)
+                    if (hide_unselected && selected_sat != NULL && satellites[i] != selected_sat)
                         continue;
 
-                    Vector3 draw_pos = Vector3Scale(satellites[i].current_pos, 1.0f / DRAW_SCALE);
+                    Vector3 draw_pos = Vector3Scale(sat_current_pos[i], 1.0f / DRAW_SCALE);
                     if (Vector3DistanceSqr(Camera3DParams.target, draw_pos) > (camDistance * camDistance * 16.0f))
                         continue;
 
@@ -1209,7 +1333,7 @@ int main(void)
                             if (distToRaySqr < hit_radius_sqr && proj < closest_dist)
                             {
                                 closest_dist = proj;
-                                hovered_sat = &satellites[i];
+                                hovered_sat = satellites[i];
                             }
                         }
                     }
@@ -1329,9 +1453,9 @@ int main(void)
 
         Satellite *active_sat = hovered_sat ? hovered_sat : selected_sat;
 
-        if (!is_2d_view && is_pov_mode && selected_sat && selected_sat->is_active)
+        if (!is_2d_view && is_pov_mode && selected_sat && sat_active[selected_sat->id])
         {
-            Vector3 sat_pos_3d = Vector3Scale(selected_sat->current_pos, 1.0f / DRAW_SCALE);
+            Vector3 sat_pos_3d = Vector3Scale(sat_current_pos[selected_sat->id], 1.0f / DRAW_SCALE);
             Camera3DParams.position = sat_pos_3d;
             
             /* create an LVLH local coordinate frame */
@@ -1383,14 +1507,14 @@ int main(void)
         Vector3 fp_grid[FP_RINGS + 1][FP_PTS];
         bool has_footprint = false;
 
-        if (active_sat && active_sat->is_active)
+        if (active_sat && sat_active[active_sat->id])
         {
-            float r = Vector3Length(active_sat->current_pos);
+            float r = Vector3Length(sat_current_pos[active_sat->id]);
             if (r > EARTH_RADIUS_KM)
             {
                 has_footprint = true;
                 float theta = acosf(EARTH_RADIUS_KM / r);
-                Vector3 s_norm = Vector3Normalize(active_sat->current_pos);
+                Vector3 s_norm = Vector3Normalize(sat_current_pos[active_sat->id]);
                 Vector3 up = fabsf(s_norm.y) > 0.99f ? (Vector3){1, 0, 0} : (Vector3){0, 1, 0};
                 Vector3 u = Vector3Normalize(Vector3CrossProduct(up, s_norm));
                 Vector3 v = Vector3CrossProduct(s_norm, u);
@@ -1465,7 +1589,7 @@ int main(void)
                 BeginScissorMode(sc_x, sc_y, sc_w, sc_h);
 
                 /* draw 2d footprint */
-                if (active_sat && has_footprint && active_sat->is_active && !(is_pov_mode && selected_sat != NULL))
+                if (active_sat && has_footprint && sat_active[active_sat->id] && !(is_pov_mode && selected_sat != NULL))
                 {
                     for (int i = 0; i < FP_RINGS; i++)
                     {
@@ -1522,24 +1646,24 @@ int main(void)
                 /* render all sats on 2d map */
                 for (int i = 0; i < sat_count; i++)
                 {
-                    if (!satellites[i].is_active)
+                    if (!sat_active[i])
                         continue;
-                    bool is_unselected = (selected_sat != NULL && &satellites[i] != selected_sat);
+                    bool is_unselected = (selected_sat != NULL && satellites[i] != selected_sat);
                     float sat_alpha = is_unselected ? unselected_fade : 1.0f;
                     if (sat_alpha <= 0.0f)
                         continue;
 
-                    bool is_hl = (active_sat == &satellites[i]);
-                    Color sCol = (selected_sat == &satellites[i]) ? cfg.sat_selected : (hovered_sat == &satellites[i]) ? cfg.sat_highlighted : cfg.sat_normal;
+                    bool is_hl = (active_sat == satellites[i]);
+                    Color sCol = (selected_sat == satellites[i]) ? cfg.sat_selected : (hovered_sat == satellites[i]) ? cfg.sat_highlighted : cfg.sat_normal;
                     sCol = ApplyAlpha(sCol, sat_alpha);
 
-                    if (is_hl && !(is_pov_mode && &satellites[i] == selected_sat))
+                    if (is_hl && !(is_pov_mode && satellites[i] == selected_sat))
                     {
                         int segments = fmin(4000, fmax(50, (int)(400 * cfg.orbits_to_draw)));
                         Vector2 track_pts[4001];
                         bool is_sunlit_arr[4001];
 
-                        double period_days = (2.0 * PI / satellites[i].mean_motion) / 86400.0;
+                        double period_days = (2.0 * PI / satellites[i]->mean_motion) / 86400.0;
                         double time_step = (period_days * cfg.orbits_to_draw) / segments;
 
                         Vector3 base_sun_dir = {0};
@@ -1548,12 +1672,19 @@ int main(void)
                             base_sun_dir = Vector3Normalize(calculate_sun_position(current_epoch));
                         }
 
+                        /* first point sits at the current time, the rest on a fixed grid so the track doesn't shimmer */
+                        double grid_start = current_epoch - fmod(current_epoch, time_step);
+                        GmstSweep track_gmst;
+                        gmst_sweep_begin(&track_gmst, grid_start + time_step, time_step);
+
                         for (int j = 0; j <= segments; j++)
                         {
-                            double t = (j == 0) ? current_epoch : (current_epoch - fmod(current_epoch, time_step) + (j * time_step));
+                            double t = (j == 0) ? current_epoch : (grid_start + (j * time_step));
                             double t_unix = get_unix_from_epoch(t);
-                            Vector3 raw_pos = calculate_position(&satellites[i], t_unix);
-                            get_map_coordinates(raw_pos, epoch_to_gmst(t), cfg.earth_rotation_offset, map_w, map_h, &track_pts[j].x, &track_pts[j].y);
+                            Vector3 raw_pos = calculate_position(satellites[i], t_unix);
+                            get_map_coordinates(raw_pos, (j == 0) ? gmst_deg : track_gmst.gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &track_pts[j].x, &track_pts[j].y);
+                            if (j > 0)
+                                gmst_sweep_next(&track_gmst);
 
                             if (cfg.highlight_sunlit)
                             {
@@ -1581,8 +1712,8 @@ int main(void)
                             }
 
                             Vector2 peri2d, apo2d;
-                            get_apsis_2d(&satellites[i], current_epoch, false, gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &peri2d);
-                            get_apsis_2d(&satellites[i], current_epoch, true, gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &apo2d);
+                            get_apsis_2d(satellites[i], current_epoch, false, gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &peri2d);
+                            get_apsis_2d(satellites[i], current_epoch, true, gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &apo2d);
 
                             DrawTexturePro(
                                 periMark, (Rectangle){0, 0, periMark.width, periMark.height}, (Rectangle){peri2d.x + x_off, peri2d.y, mark_size_2d, mark_size_2d},
@@ -1595,9 +1726,8 @@ int main(void)
                         }
                     }
 
-                    float sat_mx, sat_my;
-                    get_map_coordinates(satellites[i].current_pos, gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &sat_mx, &sat_my);
-                    if (!(is_pov_mode && &satellites[i] == selected_sat))
+                    float sat_mx = sat_screen_pos[i].x, sat_my = sat_screen_pos[i].y;
+                    if (!(is_pov_mode && satellites[i] == selected_sat))
                     {
                         for (int offset_i = -1; offset_i <= 1; offset_i++)
                         {
@@ -1608,7 +1738,7 @@ int main(void)
 
                             if (is_hl && Camera2DParams.zoom > 0.1f)
                             {
-                                DrawUIText(customFont, satellites[i].name, sat_mx + (offset_i * map_w) + (m_size_2d / 2.f) + 4.f, sat_my - (m_size_2d / 2.f), m_text_2d, sCol);
+                                DrawUIText(customFont, satellites[i]->name, sat_mx + (offset_i * map_w) + (m_size_2d / 2.f) + 4.f, sat_my - (m_size_2d / 2.f), m_text_2d, sCol);
                             }
                         }
                     }
@@ -1631,10 +1761,10 @@ int main(void)
                 }
 
                 /* slant range overlay 2d */
-                if (cfg.show_slant_range && active_sat && active_sat->is_active)
+                if (cfg.show_slant_range && active_sat && sat_active[active_sat->id])
                 {
                     float sx, sy;
-                    get_map_coordinates(active_sat->current_pos, gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &sx, &sy);
+                    get_map_coordinates(sat_current_pos[active_sat->id], gmst_deg, cfg.earth_rotation_offset, map_w, map_h, &sx, &sy);
 
                     if (sx - hx > map_w / 2.0f)
                         sx -= map_w;
@@ -1803,7 +1933,7 @@ int main(void)
             DrawSphere(sun_pos_3d, sun_radius, (Color){ 255, 250, 180, 255 });
 
             /* 3d footprint triangles */
-            if (active_sat && has_footprint && active_sat->is_active && !(is_pov_mode && selected_sat != NULL))
+            if (active_sat && has_footprint && sat_active[active_sat->id] && !(is_pov_mode && selected_sat != NULL))
             {
                 for (int i = 0; i < FP_RINGS; i++)
                 {
@@ -1823,35 +1953,38 @@ int main(void)
                 }
             }
 
+            OrbitView orbit_view = GetOrbitView(Camera3DParams);
             for (int i = 0; i < sat_count; i++)
             {
-                if (!satellites[i].is_active)
+                if (!sat_active[i])
                     continue;
-                bool is_unselected = (selected_sat != NULL && &satellites[i] != selected_sat);
+                bool is_unselected = (selected_sat != NULL && satellites[i] != selected_sat);
                 float sat_alpha = is_unselected ? unselected_fade : 1.0f;
                 if (sat_alpha <= 0.0f)
                     continue;
 
-                bool is_hl = (active_sat == &satellites[i]);
-                if (!(is_pov_mode && &satellites[i] == selected_sat))
+                bool is_hl = (active_sat == satellites[i]);
+                if (!(is_pov_mode && satellites[i] == selected_sat))
                 {
-                    draw_orbit_3d(&satellites[i], current_epoch, is_hl, sat_alpha, global_orbit_step);
+                    bool is_focused = is_hl || satellites[i] == selected_sat || satellites[i] == hovered_sat;
+                    mark_orbit_drawn(satellites[i], is_focused ? ORBIT_PRIORITY_FOCUSED : GetOrbitScreenSize(&orbit_view, satellites[i]));
+                    draw_orbit_3d(satellites[i], current_epoch, is_hl, sat_alpha, global_orbit_step);
                 }
 
-                if (is_hl && !(is_pov_mode && &satellites[i] == selected_sat))
+                if (is_hl && !(is_pov_mode && satellites[i] == selected_sat))
                 {
-                    Vector3 draw_pos = Vector3Scale(satellites[i].current_pos, 1.0f / DRAW_SCALE);
+                    Vector3 draw_pos = Vector3Scale(sat_current_pos[i], 1.0f / DRAW_SCALE);
                     DrawLine3D(Vector3Zero(), draw_pos, ApplyAlpha(cfg.orbit_highlighted, sat_alpha));
                 }
             }
 
             /* slant range overlay 3d line */
-            if (cfg.show_slant_range && active_sat && active_sat->is_active)
+            if (cfg.show_slant_range && active_sat && sat_active[active_sat->id])
             {
                 float h_lat_rad = home_location.lat * DEG2RAD;
                 float h_lon_rad = (home_location.lon + gmst_deg + cfg.earth_rotation_offset) * DEG2RAD;
                 Vector3 h_pos3d = {cosf(h_lat_rad) * cosf(h_lon_rad) * draw_earth_radius, sinf(h_lat_rad) * draw_earth_radius, -cosf(h_lat_rad) * sinf(h_lon_rad) * draw_earth_radius};
-                Vector3 s_pos3d = Vector3Scale(active_sat->current_pos, 1.0f / DRAW_SCALE);
+                Vector3 s_pos3d = Vector3Scale(sat_current_pos[active_sat->id], 1.0f / DRAW_SCALE);
                 DrawLine3D(h_pos3d, s_pos3d, ApplyAlpha(cfg.ui_accent, 0.6f));
             }
 
@@ -1912,12 +2045,12 @@ int main(void)
             Vector3 camForward = Vector3Normalize(Vector3Subtract(Camera3DParams.target, Camera3DParams.position));
 
             /* slant range text overlay 3d */
-            if (cfg.show_slant_range && active_sat && active_sat->is_active)
+            if (cfg.show_slant_range && active_sat && sat_active[active_sat->id])
             {
                 float h_lat_rad = home_location.lat * DEG2RAD;
                 float h_lon_rad = (home_location.lon + gmst_deg + cfg.earth_rotation_offset) * DEG2RAD;
                 Vector3 h_pos3d = {cosf(h_lat_rad) * cosf(h_lon_rad) * draw_earth_radius, sinf(h_lat_rad) * draw_earth_radius, -cosf(h_lat_rad) * sinf(h_lon_rad) * draw_earth_radius};
-                Vector3 s_pos3d = Vector3Scale(active_sat->current_pos, 1.0f / DRAW_SCALE);
+                Vector3 s_pos3d = Vector3Scale(sat_current_pos[active_sat->id], 1.0f / DRAW_SCALE);
 
                 Vector3 mid_pos = Vector3Lerp(h_pos3d, s_pos3d, 0.5f);
                 Vector3 toMid = Vector3Subtract(mid_pos, Camera3DParams.position);
@@ -1936,7 +2069,7 @@ int main(void)
             }
 
             bool hide_apsis = (is_pov_mode && selected_sat != NULL && active_sat == selected_sat);
-            if (active_sat && active_sat->is_active && !hide_apsis)
+            if (active_sat && sat_active[active_sat->id] && !hide_apsis)
             {
                 bool is_unselected = (selected_sat != NULL && active_sat != selected_sat);
                 float sat_alpha = is_unselected ? unselected_fade : 1.0f;
@@ -1967,29 +2100,29 @@ int main(void)
 
             for (int i = 0; i < sat_count; i++)
             {
-                if (!satellites[i].is_active)
+                if (!sat_active[i])
                     continue;
-                bool is_unselected = (selected_sat != NULL && &satellites[i] != selected_sat);
+                bool is_unselected = (selected_sat != NULL && satellites[i] != selected_sat);
                 float sat_alpha = is_unselected ? unselected_fade : 1.0f;
                 if (sat_alpha <= 0.0f)
                     continue;
 
-                Vector3 draw_pos = Vector3Scale(satellites[i].current_pos, 1.0f / DRAW_SCALE);
+                Vector3 draw_pos = Vector3Scale(sat_current_pos[i], 1.0f / DRAW_SCALE);
                 Vector3 toTarget = Vector3Subtract(draw_pos, Camera3DParams.position);
 
                 if (Vector3DotProduct(toTarget, camForward) > 0.0f && !IsOccludedByEarth(Camera3DParams.position, draw_pos, draw_earth_radius))
                 {
-                    if (!(is_pov_mode && &satellites[i] == selected_sat))
+                    if (!(is_pov_mode && satellites[i] == selected_sat))
                     {
-                        bool is_hl = (active_sat == &satellites[i]);
-                        Color sCol = (selected_sat == &satellites[i]) ? cfg.sat_selected : (hovered_sat == &satellites[i]) ? cfg.sat_highlighted : cfg.sat_normal;
+                        bool is_hl = (active_sat == satellites[i]);
+                        Color sCol = (selected_sat == satellites[i]) ? cfg.sat_selected : (hovered_sat == satellites[i]) ? cfg.sat_highlighted : cfg.sat_normal;
                         sCol = ApplyAlpha(sCol, sat_alpha);
                         Vector2 sp = GetWorldToScreen(draw_pos, Camera3DParams);
                         DrawTexturePro(satIcon, (Rectangle){0, 0, satIcon.width, satIcon.height}, (Rectangle){sp.x, sp.y, m_size_3d, m_size_3d}, (Vector2){m_size_3d / 2.f, m_size_3d / 2.f}, 0.0f, sCol);
 
                         if (is_hl)
                         {
-                            DrawUIText(customFont, satellites[i].name, sp.x + (m_size_3d / 2.f) + 4.f, sp.y - (m_size_3d / 2.f), m_text_3d, sCol);
+                            DrawUIText(customFont, satellites[i]->name, sp.x + (m_size_3d / 2.f) + 4.f, sp.y - (m_size_3d / 2.f), m_text_3d, sCol);
                         }
                     }
                 }
@@ -2114,7 +2247,11 @@ int main(void)
     UnloadFont(customFont);
 
     SaveSatSelection();
+    SavePassCache();
     RotatorShutdown();
+    stop_orbit_cache_builder();
+    stop_ephemeris_builder();
+    WorkerPoolShutdown();
 
     CloseWindow();
     return 0;
@@ -323,7 +323,9 @@ void RotatorUpdateControl(UIContext *ctx, bool show_scope_dialog, bool show_pola
             target_el = *ctx->scope_el;
             has_target = true;
         }
-        else if (rot.steer_mode == ROTATOR_STEER_POLAR && show_polar_dialog && !polar_lunar_mode && selected_pass_idx >= 0 && selected_pass_idx < num_passes)
+        /* the rotator sits at home, a pass predicted for one of the other sites has the wrong times and geometry for it */
+        else if (rot.steer_mode == ROTATOR_STEER_POLAR && show_polar_dialog && !polar_lunar_mode && selected_pass_idx >= 0 && selected_pass_idx < num_passes &&
+                 passes[selected_pass_idx].observer == 0)
         {
             SatPass *p = &passes[selected_pass_idx];
             int lead_sec = RotatorGetLeadTimeSec();
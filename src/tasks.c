@@ -0,0 +1,104 @@
+#include "tasks.h"
+#include "workers.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* share of each frame the tasks get, the rest is left for drawing */
+#define TASK_FRAME_SHARE 0.25f
+#define TASK_MIN_BUDGET_MS 1.0f
+
+typedef struct
+{
+    bool pending;
+    unsigned int order;
+    char label[48];
+    TaskStepFn step;
+    TaskFreeFn free_fn;
+    void *state;
+    float progress;
+} Task;
+
+static Task tasks[TASK_KIND_COUNT];
+static unsigned int task_order = 0;
+
+static void TaskRelease(Task *t)
+{
+    if (t->free_fn)
+        t->free_fn(t->state);
+    t->pending = false;
+    t->state = NULL;
+}
+
+void TaskCancel(TaskKind kind)
+{
+    if (tasks[kind].pending)
+        TaskRelease(&tasks[kind]);
+}
+
+void TaskSubmit(TaskKind kind, const char *label, TaskStepFn step, TaskFreeFn free_fn, void *state)
+{
+    TaskCancel(kind);
+    Task *t = &tasks[kind];
+    t->pending = true;
+    t->order = task_order++;
+    strncpy(t->label, label, sizeof(t->label) - 1);
+    t->label[sizeof(t->label) - 1] = '\0';
+    t->step = step;
+    t->free_fn = free_fn;
+    t->state = state;
+    t->progress = 0.0f;
+}
+
+bool TaskIsPending(TaskKind kind)
+{
+    return tasks[kind].pending;
+}
+
+float TaskGetProgress(TaskKind kind)
+{
+    return tasks[kind].pending ? tasks[kind].progress : 1.0f;
+}
+
+/* oldest pending task, for the status line; NULL when idle */
+const char *TaskGetActive(float *progress)
+{
+    Task *oldest = NULL;
+    for (int k = 0; k < TASK_KIND_COUNT; k++)
+        if (tasks[k].pending && (!oldest || tasks[k].order < oldest->order))
+            oldest = &tasks[k];
+    if (!oldest)
+        return NULL;
+    if (progress)
+        *progress = oldest->progress;
+    return oldest->label;
+}
+
+float TaskFrameBudgetMs(int target_fps)
+{
+    if (target_fps <= 0)
+        target_fps = 60;
+    float budget = 1000.0f / target_fps * TASK_FRAME_SHARE;
+    return budget < TASK_MIN_BUDGET_MS ? TASK_MIN_BUDGET_MS : budget;
+}
+
+/* once per frame: oldest task first, until the budget's gone or somebody yields */
+void RunTasks(float budget_ms)
+{
+    double deadline = WorkerClockMs() + budget_ms;
+    while (1)
+    {
+        Task *next = NULL;
+        for (int k = 0; k < TASK_KIND_COUNT; k++)
+            if (tasks[k].pending && (!next || tasks[k].order < next->order))
+                next = &tasks[k];
+        if (!next)
+            break;
+
+        if (!next->step(next->state, deadline, &next->progress))
+            break;
+        TaskRelease(next);
+        if (WorkerClockMs() >= deadline)
+            break;
+    }
+}
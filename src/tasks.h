@@ -0,0 +1,30 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <stdbool.h>
+
+/* cooperative jobs for the main thread. a step keeps doing small slices of work until the deadline
+   (WorkerClockMs time) and returns true once it's finished; it should always get at least one slice done
+   so a tiny budget still makes progress. there's one slot per kind, submitting again replaces whatever
+   was queued before */
+typedef enum
+{
+    TASK_PASSES = 0,
+    TASK_LUNAR_PASS,
+    TASK_TLE_RELOAD,
+    TASK_THEME_RELOAD,
+    TASK_KIND_COUNT
+} TaskKind;
+
+typedef bool (*TaskStepFn)(void *state, double deadline_ms, float *progress);
+typedef void (*TaskFreeFn)(void *state);
+
+void TaskSubmit(TaskKind kind, const char *label, TaskStepFn step, TaskFreeFn free_fn, void *state);
+void TaskCancel(TaskKind kind);
+bool TaskIsPending(TaskKind kind);
+float TaskGetProgress(TaskKind kind);
+const char *TaskGetActive(float *progress);
+float TaskFrameBudgetMs(int target_fps);
+void RunTasks(float budget_ms);
+
+#endif // TASKS_H
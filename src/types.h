@@ -8,19 +8,66 @@
 #include <sys/types.h>
 
 // basic limits and math constants
-#define MAX_SATELLITES 15000
 #define MAX_MARKERS 100
 #define EARTH_RADIUS_KM 6371.0f
 #define MOON_RADIUS_KM 1737.4f
 #define MU 398600.4418f
 #define DRAW_SCALE 3000.0f
+#define EARTH_ROTATION_RATE 7.2921158553e-5  // rad/s, sidereal
 
-#define ORBIT_CACHE_SIZE 361
+#define ORBIT_CACHE_SIZE 361  // most points a cached orbit gets (high eccentricity)
 #define MAX_CUSTOM_TLE_SOURCES 20
 
-// keeps track of satellite data
+// resonance integrator snapshot for deep-space sats (atime/xli/xni out of the elsetrec)
 typedef struct
 {
+    double atime;
+    double xli;
+    double xni;
+} DeepSpaceCheckpoint;
+
+// one checkpoint per simulated day on each side of the TLE epoch, grown on demand
+typedef struct
+{
+    DeepSpaceCheckpoint *days[2];  // [0] forward of epoch, [1] backward
+    int count[2];
+    int capacity[2];
+} DeepSpaceCheckpoints;
+
+#define EPHEM_CHEB_COEFFS 10
+#define EPHEM_MAX_SEGMENTS 8
+
+// piecewise chebyshev fit of sgp4 output (raw TEME km), refit in the background as sim time moves on.
+// seq is odd while the builder is writing, readers bail back to sgp4 if it moves under them
+typedef struct
+{
+    volatile unsigned int seq;
+    bool valid;
+    double t_start;       // unix seconds
+    double seg_len;       // seconds per segment
+    int num_segments;
+    float tolerance_km;   // tolerance this window was fitted against
+    float fit_error_km;   // worst residual seen at the check points
+    double coef[EPHEM_MAX_SEGMENTS][3][EPHEM_CHEB_COEFFS];
+} EphemerisWindow;
+
+// one finished orbit ring. the builder fills a fresh one off to the side and swaps it into sat->orbit_cache,
+// so whatever the renderer picked up stays complete and untouched for the rest of its frame
+typedef struct OrbitCache
+{
+    int resolution;  // How many points r valid
+    double step;     // seconds between points, one period across the whole ring
+    long long k0;    // time grid index (unix / step) of the oldest point, sits at slot k0 % resolution
+    struct OrbitCache *retired_next;  // builder bookkeeping once it's been swapped out
+    unsigned int retired_frame;
+    Vector3 points[];
+} OrbitCache;
+
+// keeps track of satellite data. this is the cold side: the per-frame stuff (active flag, current and
+// screen positions) lives in the sat_* arrays below, indexed by id, so frame loops don't drag this in
+typedef struct Satellite
+{
+    int id;  // index into satellites[] and the hot arrays
     char name[32];
     char norad_id[6];
     char intl_designator[8];
@@ -33,16 +80,17 @@ typedef struct
     double mean_anomaly;
     double mean_motion;
     double semi_major_axis;
-    Vector3 current_pos;
 
-    struct elsetrec satrec;
+    struct elsetrec satrec;      // live state, main thread and frame workers propagate through it
+    struct elsetrec satrec_tle;  // as sgp4init left it, only written on (re)load. what the background builders copy
+    DeepSpaceCheckpoints ds_checkpoints;
+    EphemerisWindow *ephem;  // allocated by the ephemeris builder on first fit
 
-    Vector3 orbit_cache[ORBIT_CACHE_SIZE];
-    int orbit_cache_resolution;  // How many points r valid
-    Vector3 cached_orbit_base_pos;  // Position when cache was last calculated
-    double cached_orbit_epoch;  // Epoch when cache was last calculated
-    bool orbit_cached;
-    bool is_active;
+    OrbitCache *volatile orbit_cache;  // published by the orbit cache builder, NULL until the orbit gets drawn
+    unsigned int orbit_wanted_frame;  // last frame the orbit was drawn
+    float orbit_priority;             // rebuild order, see ORBIT_PRIORITY_FOCUSED
+    struct Satellite *orbit_lru_prev;  // pool LRU links, builder thread only
+    struct Satellite *orbit_lru_next;
 } Satellite;
 
 typedef struct
@@ -51,6 +99,7 @@ typedef struct
     float lat;
     float lon;
     float alt;
+    bool passes;  // also gets predicted for in the passes window, next to home
 } Marker;
 
 typedef struct
@@ -60,8 +109,16 @@ typedef struct
     bool selected;
 } CustomTLESource;
 
-extern Satellite satellites[MAX_SATELLITES];
+// growable catalog; satellites[i] points into chunked storage that never moves, so Satellite * handles
+// stay valid as it grows
+extern Satellite **satellites;
 extern int sat_count;
+extern int sat_capacity;
+
+// hot per-frame state, parallel to satellites[] and grown with it
+extern bool *sat_active;
+extern Vector3 *sat_current_pos;  // ECI, km
+extern Vector2 *sat_screen_pos;   // 2D map-plane position for this frame (2D view only)
 
 extern Marker home_location;
 extern Marker markers[MAX_MARKERS];
@@ -79,7 +136,11 @@ typedef struct
     float ui_scale;
     float earth_rotation_offset;
     float orbits_to_draw;
-    float orbit_cache_drift_threshold_km;  // Recalculate cache if satellite drifts more than this (default 50 km)
+    int worker_threads;                    // propagation worker threads, 0 = one per core
+    float ephemeris_tolerance_km;          // max chebyshev fit error before falling back to shorter segments, 0 = off
+    int orbit_cache_budget_mb;             // orbit cache pool size, least recently drawn get evicted past this
+    float orbit_cache_frame_ms;            // time the orbit cache builder may spend per frame, 0 = no limit
+    float pass_horizon_days;               // how far ahead pass prediction looks, up to PASS_MAX_HORIZON_DAYS
     bool show_clouds;
     bool show_night_lights;
     bool show_markers;
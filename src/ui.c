@@ -3,6 +3,8 @@
 #include "ui.h"
 #include "astro.h"
 #include "rotator.h"
+#include "tasks.h"
+#include "workers.h"
 #include <ctype.h>
 #include <math.h>
 #include <raymath.h>
@@ -188,6 +190,9 @@ static bool multi_pass_mode = true;
 static Satellite *locked_pass_sat = NULL;
 static double locked_pass_aos = 0.0;
 static double locked_pass_los = 0.0;
+static int locked_pass_observer = 0;
+static bool show_pass_sites = false;   // passes window shows the site checklist instead of the list
+static int pass_view_observer = -1;    // only list passes for this pass_observers[] entry, -1 = all of them
 static char text_min_el[8] = "0";
 static bool edit_min_el = false;
 
@@ -504,7 +509,182 @@ static bool DownloadTLESource(CURL *curl, const char *url, FILE *out)
     return ok;
 }
 
-static void ReloadTLEsLocally(UIContext *ctx, AppConfig *cfg)
+/* pass prediction goes through the task queue too. the search keeps its state between runs, so time moving
+   on or a sat getting (un)checked only redoes the part that changed. whatever each slice finds gets published
+   straight away, so the list fills in while the search is still going */
+static PassSearch pass_search;
+static Satellite *pass_task_sat = NULL;  // what the pending search is for, NULL = all passes
+
+/* a finished all-sats search goes into the pass cache every time, but only gets written out every so often
+   since that can be a few MB; whatever's left goes out on exit */
+#define PASS_CACHE_SAVE_INTERVAL_MS (10 * 60 * 1000.0)
+static double pass_cache_saved_ms = 0.0;  // 0 = not written yet this run
+
+static bool PassTaskStep(void *state, double deadline_ms, float *progress)
+{
+    PassSearch *ps = (PassSearch *)state;
+    bool done = pass_search_step(ps, deadline_ms);
+    *progress = pass_search_progress(ps);
+    pass_search_publish(ps);
+    if (done && !ps->sat)
+    {
+        pass_cache_store(ps);
+        if (pass_cache_saved_ms == 0.0 || WorkerClockMs() - pass_cache_saved_ms > PASS_CACHE_SAVE_INTERVAL_MS)
+            SavePassCache();
+    }
+    return done;
+}
+
+static void SubmitPassTask(void)
+{
+    pass_task_sat = pass_search.sat;
+    TaskSubmit(TASK_PASSES, pass_search.sat ? "Predicting passes" : "Predicting all passes", PassTaskStep, NULL, &pass_search);
+}
+
+/* the coarse step gets sized to not miss anything over the min elevation filter, see pass_coarse_step.
+   markers ticked under Sites go along in the same sweep as home */
+static void StartPassCalculation(const AppConfig *cfg, Satellite *sat, double start_epoch)
+{
+    Marker sites[PASS_MAX_OBSERVERS - 1];
+    int num_sites = 0;
+    for (int i = 0; i < marker_count && num_sites < PASS_MAX_OBSERVERS - 1; i++)
+        if (markers[i].passes)
+            sites[num_sites++] = markers[i];
+    if (pass_search_begin(&pass_search, sat, start_epoch, cfg->pass_horizon_days, (float)atof(text_min_el), sites, num_sites))
+        SubmitPassTask();
+}
+
+/* where a pass was predicted from */
+static const Marker *PassSite(const SatPass *p)
+{
+    if (p->observer > 0 && p->observer < num_pass_observers)
+        return &pass_observers[p->observer].site;
+    return &home_location;
+}
+
+/* writes the passes the window is showing, one row each, times in UTC. goes to passes.csv, or
+   passes_<site>.csv when the list is down to one site */
+static void ExportPassesCSV(const int *idx, int count, const char *site_name)
+{
+    char filename[96] = "passes.csv";
+    if (site_name)
+    {
+        int n = sprintf(filename, "passes_");
+        for (const char *c = site_name; *c && n < (int)sizeof(filename) - 5; c++)
+            filename[n++] = isalnum((unsigned char)*c) ? *c : '_';
+        strcpy(filename + n, ".csv");
+    }
+
+    FILE *fp = fopen(filename, "w");
+    if (!fp)
+    {
+        printf("Failed to write %s\n", filename);
+        return;
+    }
+    fprintf(fp, "Site,Lat,Lon,Alt(km),Satellite,NORAD,AOS,Max El Time,LOS,Max El(deg),Duration(s)\n");
+    for (int k = 0; k < count; k++)
+    {
+        const SatPass *p = &passes[idx[k]];
+        const Marker *site = PassSite(p);
+        char aos_str[32], max_str[32], los_str[32];
+        epoch_to_datetime_str(p->aos_epoch, aos_str);
+        epoch_to_datetime_str(p->max_el_epoch, max_str);
+        epoch_to_datetime_str(p->los_epoch, los_str);
+        fprintf(
+            fp, "\"%s\",%.4f,%.4f,%.3f,\"%s\",%s,%s,%s,%s,%.2f,%.0f\n", site->name, site->lat, site->lon, site->alt, p->sat->name, p->sat->norad_id, aos_str, max_str,
+            los_str, p->max_el, (p->los_epoch - p->aos_epoch) * 86400.0
+        );
+    }
+    fclose(fp);
+    printf("Exported %d passes to %s\n", count, filename);
+}
+
+/* the first pass is over, or with nothing found the window start has fallen behind. an empty list has no LOS
+   to go by, but its window still has to keep up or it never finds the passes that come into it */
+static bool PassWindowBehind(double now)
+{
+    if (num_passes > 0)
+        return now > passes[0].los_epoch + 1.0 / 1440.0;
+    return pass_search.num_observers > 0 && now > pass_search.start_epoch + 1.0 / 1440.0;
+}
+
+/* drop whatever ended and only search the bit of window that opened up. the trimmed list goes out right
+   away so this doesn't fire again next frame */
+static void SlidePassWindow(double now)
+{
+    if (!pass_search_slide(&pass_search, now))
+        return;
+    pass_search_publish(&pass_search);
+    SubmitPassTask();
+}
+
+/* one sat got checked or unchecked, so only that one needs redoing. sats the search hasn't gotten to yet
+   get picked up (or skipped) when it does */
+static void RefreshSatPasses(Satellite *sat)
+{
+    if (pass_search_refresh_sat(&pass_search, sat) && !TaskIsPending(TASK_PASSES))
+        SubmitPassTask();
+}
+
+/* stops the search but keeps what it published so far, and marks it as done so it won't restart itself */
+static void CancelPassCalculation(void)
+{
+    if (!TaskIsPending(TASK_PASSES))
+        return;
+    TaskCancel(TASK_PASSES);
+    last_pass_calc_sat = pass_task_sat;
+}
+
+/* empties the list and forgets everything the search knew */
+static void ClearPasses(void)
+{
+    TaskCancel(TASK_PASSES);
+    pass_search_abort(&pass_search);
+    num_passes = 0;
+    last_pass_calc_sat = NULL;
+}
+
+/* catalog reloads run as a main-thread task a slice at a time. new sats stay unchecked until the whole
+   file is in, then the usual selection rules get applied in one go */
+typedef struct
+{
+    TleLoader loader;
+    AppConfig *cfg;
+    bool from_pull;  // fresh download: big catalogs start with nothing checked
+} TLEReloadTask;
+
+static bool TLEReloadStep(void *state, double deadline_ms, float *progress)
+{
+    TLEReloadTask *task = (TLEReloadTask *)state;
+    bool done = tle_loader_step(&task->loader, deadline_ms);
+    *progress = tle_loader_progress(&task->loader);
+    if (!done)
+        return false;
+
+    load_manual_tles(task->cfg);
+    bool activate = !task->from_pull || sat_count <= 500;
+    for (int i = 0; i < sat_count; i++)
+        sat_active[i] = activate;
+    LoadSatSelection();
+    if (task->from_pull)
+        data_tle_epoch = time(NULL);
+
+    /* a search started while this was loading saw half a catalog and none of the selection */
+    if (pass_search.num_observers > 0)
+        StartPassCalculation(task->cfg, pass_search.sat, pass_search.start_epoch);
+    return true;
+}
+
+static void TLEReloadFree(void *state)
+{
+    TLEReloadTask *task = (TLEReloadTask *)state;
+    tle_loader_close(&task->loader);
+    if (task->from_pull)
+        pull_state = PULL_IDLE;
+    free(task);
+}
+
+static void StartTLEReload(UIContext *ctx, AppConfig *cfg, bool from_pull)
 {
     if (ctx)
     {
@@ -514,12 +694,27 @@ static void ReloadTLEsLocally(UIContext *ctx, AppConfig *cfg)
         *ctx->active_lock = LOCK_EARTH;
     }
     locked_pass_sat = NULL;
-    num_passes = 0;
-    last_pass_calc_sat = NULL;
-    sat_count = 0;
-    load_tle_data("data.tle");
-    load_manual_tles(cfg);
-    LoadSatSelection();
+    ClearPasses();
+
+    TLEReloadTask *task = (TLEReloadTask *)malloc(sizeof(TLEReloadTask));
+    if (!task || !tle_loader_open(&task->loader, "data.tle", false))
+    {
+        free(task);
+        sat_count = 0;
+        load_manual_tles(cfg);
+        LoadSatSelection();
+        if (from_pull)
+            pull_state = PULL_IDLE;
+        return;
+    }
+    task->cfg = cfg;
+    task->from_pull = from_pull;
+    TaskSubmit(TASK_TLE_RELOAD, "Loading TLEs", TLEReloadStep, TLEReloadFree, task);
+}
+
+static void ReloadTLEsLocally(UIContext *ctx, AppConfig *cfg)
+{
+    StartTLEReload(ctx, cfg, false);
 }
 
 /* background thread: downloads all selected TLE sources to data.tle */
@@ -600,79 +795,98 @@ static void PullTLEData(AppConfig *cfg)
 #endif
 }
 
-/* called each frame from DrawGUI to finish reload on the main thread */
+/* called each frame from DrawGUI to hand the downloaded file to the reload task. pull_state stays busy
+   until the catalog is fully loaded */
 static void FinishPullIfDone(UIContext *ctx, AppConfig *cfg)
 {
     if (pull_state == PULL_DONE)
     {
-        if (ctx)
-        {
-            *ctx->selected_sat = NULL;
-            ctx->hovered_sat = NULL;
-            ctx->active_sat = NULL;
-            *ctx->active_lock = LOCK_EARTH;
-        }
-        locked_pass_sat = NULL;
-        num_passes = 0;
-        last_pass_calc_sat = NULL;
-        sat_count = 0;
-        load_tle_data("data.tle");
-        load_manual_tles(cfg);
-        if (sat_count > 500)
-        {
-            for (int i = 0; i < sat_count; i++)
-                satellites[i].is_active = false;
-        }
-        LoadSatSelection();
-        data_tle_epoch = time(NULL);
-        pull_state = PULL_IDLE;
+        pull_state = PULL_BUSY;
+        StartTLEReload(ctx, cfg, true);
     }
 }
 
-static void CalculateLunarPass(double base_epoch, double *aos, double *los, Vector2 *pts, int *num_pts)
+/* moon rise/set around base_epoch for the polar plot, one phase per slice: peak, AOS, LOS, sky track */
+typedef struct
+{
+    double base_epoch;
+    int phase;
+    double peak_time;
+    double aos;
+    double los;
+} LunarPassTask;
+
+static double LunarElevation(const GmstSweep *sw, double *az)
+{
+    double el;
+    observer_look(get_home_frame(), calculate_moon_position(sw->epoch), sw->sin_theta, sw->cos_theta, az, &el);
+    return el;
+}
+
+static bool LunarPassStep(void *state, double deadline_ms, float *progress)
 {
+    LunarPassTask *task = (LunarPassTask *)state;
     double step = 10.0 / 1440.0;
-    
-    double peak_time = base_epoch;
-    double max_el = -90;
-    for(double t = base_epoch - 0.5; t <= base_epoch + 0.5; t += step)
-    {
-        double az, el;
-        get_az_el(calculate_moon_position(t), epoch_to_gmst(t), home_location.lat, home_location.lon, home_location.alt, &az, &el);
-        if(el > max_el) { max_el = el; peak_time = t; }
-    }
-    
-    double found_aos = peak_time;
-    for(double t = peak_time; t >= peak_time - 0.6; t -= step)
-    {
-        double az, el;
-        get_az_el(calculate_moon_position(t), epoch_to_gmst(t), home_location.lat, home_location.lon, home_location.alt, &az, &el);
-        if(el < 0) { found_aos = t; break; }
-    }
-    
-    double found_los = peak_time;
-    for(double t = peak_time; t <= peak_time + 0.6; t += step)
-    {
-        double az, el;
-        get_az_el(calculate_moon_position(t), epoch_to_gmst(t), home_location.lat, home_location.lon, home_location.alt, &az, &el);
-        if(el < 0) { found_los = t; break; }
-    }
-    
-    *aos = found_aos;
-    *los = found_los;
-    *num_pts = 0;
-    double pt_step = (*los - *aos) / 99.0;
-    if (pt_step > 0)
+    double az;
+    GmstSweep sw;
+
+    while (task->phase < 4)
     {
-        for (int i = 0; i < 100; i++)
+        if (task->phase == 0)
+        {
+            double max_el = -90;
+            task->peak_time = task->base_epoch;
+            for (gmst_sweep_begin(&sw, task->base_epoch - 0.5, step); sw.epoch <= task->base_epoch + 0.5; gmst_sweep_next(&sw))
+            {
+                double el = LunarElevation(&sw, &az);
+                if (el > max_el) { max_el = el; task->peak_time = sw.epoch; }
+            }
+        }
+        else if (task->phase == 1)
+        {
+            task->aos = task->peak_time;
+            for (gmst_sweep_begin(&sw, task->peak_time, -step); sw.epoch >= task->peak_time - 0.6; gmst_sweep_next(&sw))
+                if (LunarElevation(&sw, &az) < 0) { task->aos = sw.epoch; break; }
+        }
+        else if (task->phase == 2)
+        {
+            task->los = task->peak_time;
+            for (gmst_sweep_begin(&sw, task->peak_time, step); sw.epoch <= task->peak_time + 0.6; gmst_sweep_next(&sw))
+                if (LunarElevation(&sw, &az) < 0) { task->los = sw.epoch; break; }
+        }
+        else
         {
-            double pt_time = *aos + i * pt_step;
-            double az, el;
-            get_az_el(calculate_moon_position(pt_time), epoch_to_gmst(pt_time), home_location.lat, home_location.lon, home_location.alt, &az, &el);
-            if (el < 0) el = 0; 
-            pts[(*num_pts)++] = (Vector2){(float)az, (float)el};
+            lunar_aos = task->aos;
+            lunar_los = task->los;
+            lunar_num_pts = 0;
+            double pt_step = (task->los - task->aos) / 99.0;
+            if (pt_step > 0)
+            {
+                gmst_sweep_begin(&sw, task->aos, pt_step);
+                for (int i = 0; i < 100; i++, gmst_sweep_next(&sw))
+                {
+                    double el = LunarElevation(&sw, &az);
+                    if (el < 0) el = 0;
+                    lunar_path_pts[lunar_num_pts++] = (Vector2){(float)az, (float)el};
+                }
+            }
         }
+
+        task->phase++;
+        *progress = task->phase / 4.0f;
+        if (task->phase < 4 && WorkerClockMs() >= deadline_ms)
+            return false;
     }
+    return true;
+}
+
+static void StartLunarPassCalculation(double base_epoch)
+{
+    LunarPassTask *task = (LunarPassTask *)calloc(1, sizeof(LunarPassTask));
+    if (!task)
+        return;
+    task->base_epoch = base_epoch;
+    TaskSubmit(TASK_LUNAR_PASS, "Tracking the moon", LunarPassStep, free, task);
 }
 
 /* shared helper functions */
@@ -749,18 +963,6 @@ double StepTimeMultiplier(double current, bool increase)
     return next;
 }
 
-double unix_to_epoch(double target_unix)
-{
-    time_t t = (time_t)target_unix;
-    struct tm *gmt = gmtime(&t);
-    if (!gmt)
-        return get_current_real_time_epoch();
-    int year = gmt->tm_year + 1900;
-    double day_of_year = gmt->tm_yday + 1.0;
-    double fraction_of_day = (gmt->tm_hour + gmt->tm_min / 60.0 + gmt->tm_sec / 3600.0) / 24.0;
-    return (year * 1000.0) + day_of_year + fraction_of_day;
-}
-
 static bool string_contains_ignore_case(const char *haystack, const char *needle)
 {
     if (!needle || !*needle)
@@ -996,21 +1198,40 @@ void SaveSatSelection(void)
         return;
     int count = 0;
     for (int i = 0; i < sat_count; i++)
-        if (satellites[i].is_active)
+        if (sat_active[i])
             count++;
     fwrite(&count, sizeof(int), 1, f);
     for (int i = 0; i < sat_count; i++)
     {
-        if (satellites[i].is_active)
+        if (sat_active[i])
         {
-            unsigned char len = (unsigned char)strlen(satellites[i].name);
+            unsigned char len = (unsigned char)strlen(satellites[i]->name);
             fwrite(&len, 1, 1, f);
-            fwrite(satellites[i].name, 1, len, f);
+            fwrite(satellites[i]->name, 1, len, f);
         }
     }
     fclose(f);
 }
 
+/* catalog indices ordered by (name, index) so a saved name finds its first match by binary search */
+static int CompareSatNameIdx(const void *a, const void *b)
+{
+    int ia = *(const int *)a, ib = *(const int *)b;
+    int c = strcmp(satellites[ia]->name, satellites[ib]->name);
+    return c != 0 ? c : (ia - ib);
+}
+
+void SavePassCache(void)
+{
+    pass_cache_save("pass_cache.bin");
+    pass_cache_saved_ms = WorkerClockMs();
+}
+
+void LoadPassCache(void)
+{
+    pass_cache_load("pass_cache.bin");
+}
+
 void LoadSatSelection(void)
 {
     FILE *f = fopen("persistence.bin", "rb");
@@ -1024,7 +1245,18 @@ void LoadSatSelection(void)
     }
 
     for (int i = 0; i < sat_count; i++)
-        satellites[i].is_active = false;
+        sat_active[i] = false;
+
+    /* a linear scan per saved name is quadratic, and that hurts once the catalog hits six figures */
+    int *by_name = malloc((sat_count > 0 ? sat_count : 1) * sizeof(int));
+    if (!by_name)
+    {
+        fclose(f);
+        return;
+    }
+    for (int i = 0; i < sat_count; i++)
+        by_name[i] = i;
+    qsort(by_name, sat_count, sizeof(int), CompareSatNameIdx);
 
     for (int i = 0; i < count; i++)
     {
@@ -1033,15 +1265,20 @@ void LoadSatSelection(void)
         if (fread(&len, 1, 1, f) != 1)
             break;
         fread(name, 1, len, f);
-        for (int j = 0; j < sat_count; j++)
+
+        int lo = 0, hi = sat_count;
+        while (lo < hi)
         {
-            if (strcmp(satellites[j].name, name) == 0)
-            {
-                satellites[j].is_active = true;
-                break;
-            }
+            int mid = (lo + hi) / 2;
+            if (strcmp(satellites[by_name[mid]]->name, name) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
         }
+        if (lo < sat_count && strcmp(satellites[by_name[lo]]->name, name) == 0)
+            sat_active[by_name[lo]] = true;
     }
+    free(by_name);
     fclose(f);
 }
 
@@ -1728,21 +1965,33 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
     {
         if (multi_pass_mode)
         {
-            if (last_pass_calc_sat != NULL || (num_passes > 0 && *ctx->current_epoch > passes[0].los_epoch + 1.0 / 1440.0))
+            if (!TaskIsPending(TASK_PASSES) && last_pass_calc_sat != NULL)
             {
-                CalculatePasses(NULL, *ctx->current_epoch);
+                StartPassCalculation(cfg, NULL, *ctx->current_epoch);
+            }
+            else if (PassWindowBehind(*ctx->current_epoch))
+            {
+                SlidePassWindow(*ctx->current_epoch);
             }
         }
         else
         {
             if (*ctx->selected_sat == NULL)
             {
-                num_passes = 0;
-                last_pass_calc_sat = NULL;
+                ClearPasses();
+            }
+            else if (TaskIsPending(TASK_PASSES) && pass_task_sat != *ctx->selected_sat)
+            {
+                /* selection moved on while the old one was still being searched, that one's moot now */
+                StartPassCalculation(cfg, *ctx->selected_sat, *ctx->current_epoch);
+            }
+            else if (!TaskIsPending(TASK_PASSES) && last_pass_calc_sat != *ctx->selected_sat)
+            {
+                StartPassCalculation(cfg, *ctx->selected_sat, *ctx->current_epoch);
             }
-            else if (last_pass_calc_sat != *ctx->selected_sat || (num_passes > 0 && *ctx->current_epoch > passes[0].los_epoch + 1.0 / 1440.0))
+            else if (PassWindowBehind(*ctx->current_epoch))
             {
-                CalculatePasses(*ctx->selected_sat, *ctx->current_epoch);
+                SlidePassWindow(*ctx->current_epoch);
             }
         }
     }
@@ -1752,7 +2001,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
         int found_idx = -1;
         for (int i = 0; i < num_passes; i++)
         {
-            if (passes[i].sat == locked_pass_sat && fabs(passes[i].aos_epoch - locked_pass_aos) < (1.0 / 86400.0))
+            if (passes[i].sat == locked_pass_sat && passes[i].observer == locked_pass_observer && fabs(passes[i].aos_epoch - locked_pass_aos) < (1.0 / 86400.0))
             {
                 found_idx = i;
                 break;
@@ -1762,7 +2011,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
         {
             for (int i = 0; i < num_passes; i++)
             {
-                if (passes[i].sat == locked_pass_sat && passes[i].los_epoch > *ctx->current_epoch)
+                if (passes[i].sat == locked_pass_sat && passes[i].observer == locked_pass_observer && passes[i].los_epoch > *ctx->current_epoch)
                 {
                     found_idx = i;
                     locked_pass_aos = passes[i].aos_epoch;
@@ -1833,7 +2082,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
 
     /* render context-sensitive apsis text markers */
     bool hide_apsis_text = (*ctx->is_pov_mode && *ctx->selected_sat != NULL && ctx->active_sat == *ctx->selected_sat);
-    if (ctx->active_sat && ctx->active_sat->is_active && !hide_apsis_text)
+    if (ctx->active_sat && sat_active[ctx->active_sat->id] && !hide_apsis_text)
     {
         Vector2 periScreen, apoScreen;
         bool show_peri = true, show_apo = true;
@@ -2114,13 +2363,12 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
         {
             FindSmartWindowPosition(357 * cfg->ui_scale, 380 * cfg->ui_scale, cfg, &pd_x, &pd_y);
             if (multi_pass_mode)
-                CalculatePasses(NULL, *ctx->current_epoch);
+                StartPassCalculation(cfg, NULL, *ctx->current_epoch);
             else if (*ctx->selected_sat)
-                CalculatePasses(*ctx->selected_sat, *ctx->current_epoch);
+                StartPassCalculation(cfg, *ctx->selected_sat, *ctx->current_epoch);
             else
             {
-                num_passes = 0;
-                last_pass_calc_sat = NULL;
+                ClearPasses();
             }
         }
         show_passes_dialog = !show_passes_dialog;
@@ -2501,19 +2749,31 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             bool doCheckAll = GuiButton((Rectangle){sm_x + smWindow.width - 75 * cfg->ui_scale, sm_y + 35 * cfg->ui_scale, 30 * cfg->ui_scale, 24 * cfg->ui_scale}, "#80#");
             bool doUncheckAll = GuiButton((Rectangle){sm_x + smWindow.width - 40 * cfg->ui_scale, sm_y + 35 * cfg->ui_scale, 30 * cfg->ui_scale, 24 * cfg->ui_scale}, "#79#");
 
-            int filtered_indices[MAX_SATELLITES], filtered_count = 0;
+            static int *filtered_indices = NULL;
+            static int filtered_capacity = 0;
+            int filtered_count = 0;
+            if (filtered_capacity < sat_count)
+            {
+                int *grown = realloc(filtered_indices, sat_count * sizeof(int));
+                if (grown)
+                {
+                    filtered_indices = grown;
+                    filtered_capacity = sat_count;
+                }
+            }
             for (int i = 0; i < sat_count; i++)
             {
-                if (string_contains_ignore_case(satellites[i].name, sat_search_text) || 
-                    string_contains_ignore_case(satellites[i].norad_id, sat_search_text) || 
-                    string_contains_ignore_case(satellites[i].intl_designator, sat_search_text))
+                if (string_contains_ignore_case(satellites[i]->name, sat_search_text) || 
+                    string_contains_ignore_case(satellites[i]->norad_id, sat_search_text) || 
+                    string_contains_ignore_case(satellites[i]->intl_designator, sat_search_text))
 
                 {
-                    filtered_indices[filtered_count++] = i;
+                    if (filtered_count < filtered_capacity)
+                        filtered_indices[filtered_count++] = i;
                     if (doCheckAll)
-                        satellites[i].is_active = true;
+                        sat_active[i] = true;
                     if (doUncheckAll)
-                        satellites[i].is_active = false;
+                        sat_active[i] = false;
                 }
             }
 
@@ -2523,9 +2783,9 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                 if (show_passes_dialog)
                 {
                     if (multi_pass_mode)
-                        CalculatePasses(NULL, *ctx->current_epoch);
+                        StartPassCalculation(cfg, NULL, *ctx->current_epoch);
                     else if (*ctx->selected_sat)
-                        CalculatePasses(*ctx->selected_sat, *ctx->current_epoch);
+                        StartPassCalculation(cfg, *ctx->selected_sat, *ctx->current_epoch);
                 }
             }
 
@@ -2561,22 +2821,17 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                     Rectangle cbRec = {viewRec.x + 4 * cfg->ui_scale + sat_mgr_scroll.x, item_y + 4 * cfg->ui_scale, 16 * cfg->ui_scale, 16 * cfg->ui_scale};
                     Rectangle textRec = {viewRec.x + 24 * cfg->ui_scale + sat_mgr_scroll.x, item_y, viewRec.width - 28 * cfg->ui_scale, 25 * cfg->ui_scale};
 
-                    bool was_active = satellites[sat_idx].is_active;
-                    GuiCheckBox(cbRec, "", &satellites[sat_idx].is_active);
+                    bool was_active = sat_active[sat_idx];
+                    GuiCheckBox(cbRec, "", &sat_active[sat_idx]);
 
-                    if (was_active != satellites[sat_idx].is_active)
+                    if (was_active != sat_active[sat_idx])
                     {
                         SaveSatSelection();
                         if (show_passes_dialog)
-                        {
-                            if (multi_pass_mode)
-                                CalculatePasses(NULL, *ctx->current_epoch);
-                            else if (*ctx->selected_sat)
-                                CalculatePasses(*ctx->selected_sat, *ctx->current_epoch);
-                        }
+                            RefreshSatPasses(satellites[sat_idx]);
                     }
 
-                    bool isTargeted = (*ctx->selected_sat == &satellites[sat_idx]);
+                    bool isTargeted = (*ctx->selected_sat == satellites[sat_idx]);
                     bool isHovered = is_topmost && CheckCollisionPointRec(GetMousePosition(), textRec) && CheckCollisionPointRec(GetMousePosition(), viewRec);
 
                     if (isTargeted)
@@ -2589,9 +2844,9 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                         if (isTargeted)
                             *ctx->selected_sat = NULL;
                         else
-                            *ctx->selected_sat = &satellites[sat_idx];
+                            *ctx->selected_sat = satellites[sat_idx];
                     }
-                    DrawUIText(customFont, satellites[sat_idx].name, textRec.x + 4 * cfg->ui_scale, textRec.y + 4 * cfg->ui_scale, 16 * cfg->ui_scale, isTargeted ? cfg->ui_accent : cfg->text_main);
+                    DrawUIText(customFont, satellites[sat_idx]->name, textRec.x + 4 * cfg->ui_scale, textRec.y + 4 * cfg->ui_scale, 16 * cfg->ui_scale, isTargeted ? cfg->ui_accent : cfg->text_main);
                 }
                 EndScissorMode();
             }
@@ -2814,9 +3069,9 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                 if (show_passes_dialog)
                 {
                     if (multi_pass_mode)
-                        CalculatePasses(NULL, *ctx->current_epoch);
+                        StartPassCalculation(cfg, NULL, *ctx->current_epoch);
                     else if (*ctx->selected_sat)
-                        CalculatePasses(*ctx->selected_sat, *ctx->current_epoch);
+                        StartPassCalculation(cfg, *ctx->selected_sat, *ctx->current_epoch);
                 }
             }
 
@@ -2974,20 +3229,30 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             if (DrawMaterialWindow(passesWindow, "#208# Upcoming Passes", cfg, customFont, true))
                 show_passes_dialog = false;
 
+            /* while a search is running the mode button makes room for a stop button */
+            bool passes_pending = TaskIsPending(TASK_PASSES);
+            float mode_btn_w = passesWindow.width - (passes_pending ? 188 : 160) * cfg->ui_scale;
+            if (passes_pending)
+            {
+                if (GuiButton((Rectangle){passesWindow.x + 24 * cfg->ui_scale + mode_btn_w, passesWindow.y + 30 * cfg->ui_scale, 24 * cfg->ui_scale, 24 * cfg->ui_scale}, "#133#"))
+                    CancelPassCalculation();
+                float pass_progress = TaskGetProgress(TASK_PASSES);
+                DrawRectangle(passesWindow.x + 8 * cfg->ui_scale, passesWindow.y + 56 * cfg->ui_scale, (passesWindow.width - 16 * cfg->ui_scale) * pass_progress, 2 * cfg->ui_scale, cfg->ui_accent);
+            }
+
             if (GuiButton(
-                    (Rectangle){passesWindow.x + 20 * cfg->ui_scale, passesWindow.y + 30 * cfg->ui_scale, passesWindow.width - 160 * cfg->ui_scale, 24 * cfg->ui_scale},
+                    (Rectangle){passesWindow.x + 20 * cfg->ui_scale, passesWindow.y + 30 * cfg->ui_scale, mode_btn_w, 24 * cfg->ui_scale},
                     multi_pass_mode ? "Mode: All Passes" : "Mode: Targeted only"
                 ))
             {
                 multi_pass_mode = !multi_pass_mode;
                 if (multi_pass_mode)
-                    CalculatePasses(NULL, *ctx->current_epoch);
+                    StartPassCalculation(cfg, NULL, *ctx->current_epoch);
                 else if (*ctx->selected_sat)
-                    CalculatePasses(*ctx->selected_sat, *ctx->current_epoch);
+                    StartPassCalculation(cfg, *ctx->selected_sat, *ctx->current_epoch);
                 else
                 {
-                    num_passes = 0;
-                    last_pass_calc_sat = NULL;
+                    ClearPasses();
                 }
             }
 
@@ -2997,12 +3262,40 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             );
 
             float min_el_threshold = atof(text_min_el);
-            int valid_passes[MAX_PASSES], valid_count = 0;
-            for (int i = 0; i < num_passes; i++)
-                if (passes[i].max_el >= min_el_threshold)
+            /* the search stepped coarser for a higher filter and could have gone straight over passes this one shows */
+            if (!edit_min_el && pass_search.end_epoch > 0 && fmaxf(0.0f, min_el_threshold) < pass_search.min_el)
+                StartPassCalculation(cfg, pass_search.sat, *ctx->current_epoch);
+            static int *valid_passes = NULL;
+            static int valid_capacity = 0;
+            int valid_count = 0;
+            if (valid_capacity < num_passes)
+            {
+                int *grown = realloc(valid_passes, num_passes * sizeof(int));
+                if (grown)
+                {
+                    valid_passes = grown;
+                    valid_capacity = num_passes;
+                }
+            }
+            if (pass_view_observer >= num_pass_observers)
+                pass_view_observer = -1;
+            for (int i = 0; i < num_passes && i < valid_capacity; i++)
+                if (passes[i].max_el >= min_el_threshold && (pass_view_observer < 0 || passes[i].observer == pass_view_observer))
                     valid_passes[valid_count++] = i;
 
-            Rectangle contentRec = {0, 0, passesWindow.width - 32 * cfg->ui_scale, (valid_count == 0 ? 1 : valid_count) * 55 * cfg->ui_scale};
+            /* which markers get predicted for alongside home, which one the list shows, and the export */
+            float site_btn_w = (passesWindow.width - 48 * cfg->ui_scale) / 3.0f;
+            float site_row_y = passesWindow.y + 62 * cfg->ui_scale;
+            if (GuiButton((Rectangle){passesWindow.x + 20 * cfg->ui_scale, site_row_y, site_btn_w, 24 * cfg->ui_scale}, show_pass_sites ? "Back to Passes" : "Sites"))
+                show_pass_sites = !show_pass_sites;
+            const char *view_site = pass_view_observer < 0 ? NULL : pass_view_observer == 0 ? home_location.name : pass_observers[pass_view_observer].site.name;
+            if (GuiButton((Rectangle){passesWindow.x + 24 * cfg->ui_scale + site_btn_w, site_row_y, site_btn_w, 24 * cfg->ui_scale}, view_site ? TextFormat("Site: %s", view_site) : "Site: All"))
+                pass_view_observer = (pass_view_observer + 2) % (num_pass_observers + 1) - 1;
+            if (GuiButton((Rectangle){passesWindow.x + 28 * cfg->ui_scale + 2 * site_btn_w, site_row_y, site_btn_w, 24 * cfg->ui_scale}, "Export CSV"))
+                ExportPassesCSV(valid_passes, valid_count, view_site);
+
+            int content_rows = show_pass_sites ? 0 : (valid_count == 0 ? 1 : valid_count);
+            Rectangle contentRec = {0, 0, passesWindow.width - 32 * cfg->ui_scale, show_pass_sites ? (marker_count + 1) * 25 * cfg->ui_scale : content_rows * 55 * cfg->ui_scale};
             Rectangle viewRec = {0};
 
             int oldFocusD = GuiGetStyle(DEFAULT, BORDER_COLOR_FOCUSED);
@@ -3014,7 +3307,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             GuiSetStyle(LISTVIEW, BORDER_COLOR_FOCUSED, ColorToInt(cfg->window_border_focus));
             GuiSetStyle(LISTVIEW, BORDER_COLOR_PRESSED, ColorToInt(cfg->window_border_focus));
 
-            GuiScrollPanel((Rectangle){passesWindow.x + 8 * cfg->ui_scale, passesWindow.y + 60 * cfg->ui_scale, passesWindow.width - 16 * cfg->ui_scale, passesWindow.height - 60 * cfg->ui_scale - 8 * cfg->ui_scale}, NULL, contentRec, &passes_scroll, &viewRec);
+            GuiScrollPanel((Rectangle){passesWindow.x + 8 * cfg->ui_scale, passesWindow.y + 92 * cfg->ui_scale, passesWindow.width - 16 * cfg->ui_scale, passesWindow.height - 92 * cfg->ui_scale - 8 * cfg->ui_scale}, NULL, contentRec, &passes_scroll, &viewRec);
 
             GuiSetStyle(DEFAULT, BORDER_COLOR_FOCUSED, oldFocusD);
             GuiSetStyle(DEFAULT, BORDER_COLOR_PRESSED, oldPressD);
@@ -3022,7 +3315,54 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             GuiSetStyle(LISTVIEW, BORDER_COLOR_PRESSED, oldPressL);
 
             BeginScissorMode(viewRec.x, viewRec.y, viewRec.width, viewRec.height);
-            if (!multi_pass_mode && !*ctx->selected_sat)
+            if (show_pass_sites)
+            {
+                /* home is always in, the rest share what's left of PASS_MAX_OBSERVERS */
+                int num_checked = 0;
+                for (int m = 0; m < marker_count; m++)
+                    if (markers[m].passes)
+                        num_checked++;
+
+                for (int k = 0; k <= marker_count; k++)
+                {
+                    float item_y = viewRec.y + passes_scroll.y + k * 25 * cfg->ui_scale;
+                    if (item_y + 25 * cfg->ui_scale < viewRec.y || item_y > viewRec.y + viewRec.height)
+                        continue;
+
+                    Rectangle cbRec = {viewRec.x + 4 * cfg->ui_scale + passes_scroll.x, item_y + 4 * cfg->ui_scale, 16 * cfg->ui_scale, 16 * cfg->ui_scale};
+                    float text_x = viewRec.x + 28 * cfg->ui_scale + passes_scroll.x;
+                    if (k == 0)
+                    {
+                        bool always = true;
+                        GuiDisable();
+                        GuiCheckBox(cbRec, "", &always);
+                        GuiEnable();
+                        DrawUIText(customFont, TextFormat("%s (home)", home_location.name), text_x, item_y + 4 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
+                        continue;
+                    }
+
+                    Marker *site = &markers[k - 1];
+                    bool was_checked = site->passes;
+                    bool full = !was_checked && num_checked >= PASS_MAX_OBSERVERS - 1;
+                    if (full)
+                        GuiDisable();
+                    GuiCheckBox(cbRec, "", &site->passes);
+                    if (full)
+                        GuiEnable();
+                    DrawUIText(customFont, site->name, text_x, item_y + 4 * cfg->ui_scale, 16 * cfg->ui_scale, site->passes ? cfg->ui_accent : cfg->text_main);
+
+                    if (was_checked != site->passes)
+                    {
+                        num_checked += site->passes ? 1 : -1;
+                        SaveAppConfig("settings.json", cfg);
+                        if (multi_pass_mode)
+                            StartPassCalculation(cfg, NULL, *ctx->current_epoch);
+                        else if (*ctx->selected_sat)
+                            StartPassCalculation(cfg, *ctx->selected_sat, *ctx->current_epoch);
+                    }
+                }
+            }
+            else if (!multi_pass_mode && !*ctx->selected_sat)
             {
                 DrawUIText(
                     customFont, "No satellite targeted.", viewRec.x + 10 * cfg->ui_scale + passes_scroll.x, viewRec.y + 10 * cfg->ui_scale + passes_scroll.y, 16 * cfg->ui_scale,
@@ -3032,7 +3372,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             else if (valid_count == 0)
             {
                 DrawUIText(
-                    customFont, "No passes meet your criteria.", viewRec.x + 10 * cfg->ui_scale + passes_scroll.x, viewRec.y + 10 * cfg->ui_scale + passes_scroll.y, 16 * cfg->ui_scale,
+                    customFont, TaskIsPending(TASK_PASSES) ? TextFormat("Calculating passes... %i%%", (int)(TaskGetProgress(TASK_PASSES) * 100.0f)) : "No passes meet your criteria.", viewRec.x + 10 * cfg->ui_scale + passes_scroll.x, viewRec.y + 10 * cfg->ui_scale + passes_scroll.y, 16 * cfg->ui_scale,
                     cfg->text_main
                 );
             }
@@ -3047,7 +3387,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
 
                     Rectangle rowBtn = {viewRec.x + 4 * cfg->ui_scale + passes_scroll.x, item_y, viewRec.width - 8 * cfg->ui_scale, 50 * cfg->ui_scale};
                     bool isHovered = is_topmost && CheckCollisionPointRec(GetMousePosition(), rowBtn) && CheckCollisionPointRec(GetMousePosition(), viewRec);
-                    bool isSelected = (show_polar_dialog && passes[i].sat == locked_pass_sat && fabs(passes[i].aos_epoch - locked_pass_aos) < (1.0 / 86400.0));
+                    bool isSelected = (show_polar_dialog && passes[i].sat == locked_pass_sat && passes[i].observer == locked_pass_observer && fabs(passes[i].aos_epoch - locked_pass_aos) < (1.0 / 86400.0));
 
                     if (isHovered || isSelected)
                     {
@@ -3064,6 +3404,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                             locked_pass_sat = passes[i].sat;
                             locked_pass_aos = passes[i].aos_epoch;
                             locked_pass_los = passes[i].los_epoch;
+                            locked_pass_observer = passes[i].observer;
                             *ctx->selected_sat = passes[i].sat;
                         }
                     }
@@ -3073,7 +3414,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                     epoch_to_time_str(passes[i].los_epoch, los_str);
 
                     GuiSetStyle(LABEL, TEXT_COLOR_NORMAL, ColorToInt(cfg->ui_accent));
-                    GuiLabel((Rectangle){rowBtn.x + 10 * cfg->ui_scale, rowBtn.y + 2 * cfg->ui_scale, rowBtn.width - 20 * cfg->ui_scale, 20 * cfg->ui_scale}, passes[i].sat->name);
+                    GuiLabel((Rectangle){rowBtn.x + 10 * cfg->ui_scale, rowBtn.y + 2 * cfg->ui_scale, rowBtn.width - 20 * cfg->ui_scale, 20 * cfg->ui_scale}, num_pass_observers > 1 ? TextFormat("%s  @ %s", passes[i].sat->name, PassSite(&passes[i])->name) : passes[i].sat->name);
 
                     char info_str[128];
                     sprintf(info_str, "%s -> %s   Max: %.1fdeg", aos_str, los_str, passes[i].max_el);
@@ -3118,8 +3459,8 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             bool has_data = false;
             if (polar_lunar_mode) {
                 has_data = true;
-                if (fabs(*ctx->current_epoch - last_lunar_calc_time) > 0.5 || lunar_num_pts == 0) {
-                    CalculateLunarPass(*ctx->current_epoch, &lunar_aos, &lunar_los, lunar_path_pts, &lunar_num_pts);
+                if (!TaskIsPending(TASK_LUNAR_PASS) && (fabs(*ctx->current_epoch - last_lunar_calc_time) > 0.5 || lunar_num_pts == 0)) {
+                    StartLunarPassCalculation(*ctx->current_epoch);
                     last_lunar_calc_time = *ctx->current_epoch;
                 }
             } else if (selected_pass_idx >= 0 && selected_pass_idx < num_passes) {
@@ -3139,11 +3480,13 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                 DrawUIText(customFont, "S", cx - 5 * cfg->ui_scale, cy + r_max + 5 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
                 DrawUIText(customFont, "W", cx - r_max - 20 * cfg->ui_scale, cy - 8 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
 
-                int num_pts = polar_lunar_mode ? lunar_num_pts : passes[selected_pass_idx].num_pts;
-                Vector2 *path_pts = polar_lunar_mode ? lunar_path_pts : passes[selected_pass_idx].path_pts;
+                const SkyTrack *track = polar_lunar_mode ? NULL : pass_sky_track(&passes[selected_pass_idx]);
+                int num_pts = polar_lunar_mode ? lunar_num_pts : track->num_pts;
+                const Vector2 *path_pts = polar_lunar_mode ? lunar_path_pts : track->pts;
                 double p_aos = polar_lunar_mode ? lunar_aos : passes[selected_pass_idx].aos_epoch;
                 double p_los = polar_lunar_mode ? lunar_los : passes[selected_pass_idx].los_epoch;
                 Satellite *p_sat = polar_lunar_mode ? NULL : passes[selected_pass_idx].sat;
+                const Marker *p_site = polar_lunar_mode ? &home_location : PassSite(&passes[selected_pass_idx]);
 
                 for (int k = 0; k < num_pts - 1; k++)
                 {
@@ -3193,9 +3536,9 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                 {
                     double c_az, c_el;
                     if (polar_lunar_mode) {
-                        get_az_el(calculate_moon_position(*ctx->current_epoch), epoch_to_gmst(*ctx->current_epoch), home_location.lat, home_location.lon, home_location.alt, &c_az, &c_el);
+                        get_az_el(calculate_moon_position(*ctx->current_epoch), epoch_to_gmst(*ctx->current_epoch), p_site->lat, p_site->lon, p_site->alt, &c_az, &c_el);
                     } else {
-                        get_az_el(calculate_position(p_sat, get_unix_from_epoch(*ctx->current_epoch)), epoch_to_gmst(*ctx->current_epoch), home_location.lat, home_location.lon, home_location.alt, &c_az, &c_el);
+                        get_az_el(calculate_position(p_sat, get_unix_from_epoch(*ctx->current_epoch)), epoch_to_gmst(*ctx->current_epoch), p_site->lat, p_site->lon, p_site->alt, &c_az, &c_el);
                     }
 
                     float r_c = r_max * (90 - c_el) / 90.0f;
@@ -3209,7 +3552,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                     DrawUIText(customFont, c_info, pl_x + 20 * cfg->ui_scale, pl_y + 295 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_main);
 
                     if (!polar_lunar_mode) {
-                        double s_range = get_sat_range(p_sat, *ctx->current_epoch, home_location);
+                        double s_range = get_sat_range(p_sat, *ctx->current_epoch, *p_site);
                         char rng_info[64];
                         sprintf(rng_info, "Range: %.0f km", s_range);
                         DrawUIText(customFont, rng_info, pl_x + 20 * cfg->ui_scale, pl_y + 315 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_main);
@@ -3304,6 +3647,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
             {
                 SatPass *p = &passes[selected_pass_idx];
                 Satellite *d_sat = p->sat;
+                Marker d_site = *PassSite(p);
 
                 float dy = dop_y + 35 * cfg->ui_scale;
                 GuiLabel((Rectangle){dop_x + 15 * cfg->ui_scale, dy, 200 * cfg->ui_scale, 24 * cfg->ui_scale}, "Freq (Hz):");
@@ -3332,7 +3676,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                         for (int k = 0; k <= (int)(pass_dur * res); k++)
                         {
                             double t_sec = k / res;
-                            fprintf(fp, "%.3f,%.3f\n", t_sec, calculate_doppler_freq(d_sat, p->aos_epoch + t_sec / 86400.0, home_location, base_freq));
+                            fprintf(fp, "%.3f,%.3f\n", t_sec, calculate_doppler_freq(d_sat, p->aos_epoch + t_sec / 86400.0, d_site, base_freq));
                         }
                         fclose(fp);
                     }
@@ -3350,7 +3694,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                     int plot_pts = (int)graph_w;
                     for (int k = 0; k <= plot_pts; k++)
                     {
-                        double f = calculate_doppler_freq(d_sat, p->aos_epoch + (k / (double)plot_pts) * (pass_dur / 86400.0), home_location, base_freq);
+                        double f = calculate_doppler_freq(d_sat, p->aos_epoch + (k / (double)plot_pts) * (pass_dur / 86400.0), d_site, base_freq);
                         if (f < min_f)
                             min_f = f;
                         if (f > max_f)
@@ -3372,7 +3716,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                     Vector2 prev_pt = {0};
                     for (int k = 0; k <= plot_pts; k++)
                     {
-                        double delta = calculate_doppler_freq(d_sat, p->aos_epoch + (k / (double)plot_pts) * (pass_dur / 86400.0), home_location, base_freq) - base_freq;
+                        double delta = calculate_doppler_freq(d_sat, p->aos_epoch + (k / (double)plot_pts) * (pass_dur / 86400.0), d_site, base_freq) - base_freq;
                         float px = graph_x + k, py = graph_y + graph_h - (float)((delta - min_d) / (max_d - min_d)) * graph_h;
                         if (k > 0)
                             DrawLineEx(prev_pt, (Vector2){px, py}, 2.0f, cfg->ui_accent);
@@ -3382,7 +3726,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                     if (*ctx->current_epoch >= p->aos_epoch && *ctx->current_epoch <= p->los_epoch)
                     {
                         float cx = graph_x + (((*ctx->current_epoch - p->aos_epoch) * 86400.0) / pass_dur) * graph_w;
-                        float cy = graph_y + graph_h - (float)((calculate_doppler_freq(d_sat, *ctx->current_epoch, home_location, base_freq) - base_freq - min_d) / (max_d - min_d)) * graph_h;
+                        float cy = graph_y + graph_h - (float)((calculate_doppler_freq(d_sat, *ctx->current_epoch, d_site, base_freq) - base_freq - min_d) / (max_d - min_d)) * graph_h;
                         DrawCircleV((Vector2){cx, cy}, 5.0f * cfg->ui_scale, RED);
                         DrawCircleLines(cx, cy, 7.0f * cfg->ui_scale, WHITE);
                     }
@@ -3394,7 +3738,7 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont)
                     {
                         float mouseX = GetMousePosition().x, mouseY = GetMousePosition().y;
                         double t_sec = ((mouseX - graph_x) / graph_w) * pass_dur;
-                        double f_hz = calculate_doppler_freq(d_sat, p->aos_epoch + t_sec / 86400.0, home_location, base_freq);
+                        double f_hz = calculate_doppler_freq(d_sat, p->aos_epoch + t_sec / 86400.0, d_site, base_freq);
 
                         if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
                         {
@@ -3451,7 +3795,7 @@ case WND_SCOPE:
             /* auto-aim scope if locked to a satellite */
             if (scope_lock && *ctx->selected_sat) {
                 double l_az, l_el;
-                Vector3 sat_pos = (*ctx->selected_sat)->is_active ? (*ctx->selected_sat)->current_pos : calculate_position(*ctx->selected_sat, get_unix_from_epoch(*ctx->current_epoch));
+                Vector3 sat_pos = sat_active[(*ctx->selected_sat)->id] ? sat_current_pos[(*ctx->selected_sat)->id] : calculate_position(*ctx->selected_sat, get_unix_from_epoch(*ctx->current_epoch));
                 get_az_el(sat_pos, ctx->gmst_deg, home_location.lat, home_location.lon, home_location.alt, &l_az, &l_el);
                 scope_az = (float)l_az;
                 scope_el = (float)l_el;
@@ -3550,7 +3894,7 @@ case WND_SCOPE:
             DrawCircleLines(center.x, center.y, scope_radius, cfg->ui_secondary);
 
             /* draw orbit path arch for currently targeted satellite */
-            if (*ctx->selected_sat && (*ctx->selected_sat)->is_active) {
+            if (*ctx->selected_sat && sat_active[(*ctx->selected_sat)->id]) {
                 draw_satellite_orbit_arch(*ctx->selected_sat, *ctx->current_epoch, ctx->gmst_deg, 
                                         home_location, center, scope_radius, scope_az, scope_el, 
                                         scope_beam, cfg->orbit_highlighted);
@@ -3592,11 +3936,15 @@ case WND_SCOPE:
             
             double past_epoch = *ctx->current_epoch - (60.0 / 86400.0);
             double past_unix = get_unix_from_epoch(past_epoch);
-            double past_gmst = epoch_to_gmst(past_epoch);
+            double past_theta = epoch_to_gmst(past_epoch) * DEG2RAD;
+            double past_sin = sin(past_theta), past_cos = cos(past_theta);
+            double now_theta = ctx->gmst_deg * DEG2RAD;
+            double now_sin = sin(now_theta), now_cos = cos(now_theta);
+            const ObserverFrame *home = get_home_frame();
 
             /* iterate all sats, cull, and project valid ones onto the 2d scope */
             for (int i = 0; i < sat_count; i++) {
-                double revs_per_day = (satellites[i].mean_motion * 86400.0) / (2.0 * PI);
+                double revs_per_day = (satellites[i]->mean_motion * 86400.0) / (2.0 * PI);
                 bool is_leo = (revs_per_day > 11.25);
                 bool is_geo = (revs_per_day >= 0.99 && revs_per_day <= 1.01);
                 bool is_heo = !is_leo && !is_geo;
@@ -3605,7 +3953,7 @@ case WND_SCOPE:
                 if (is_heo && !scope_show_heo) continue;
                 if (is_geo && !scope_show_geo) continue;
 
-                Vector3 sat_pos = satellites[i].is_active ? satellites[i].current_pos : calculate_position(&satellites[i], current_unix);
+                Vector3 sat_pos = sat_active[i] ? sat_current_pos[i] : calculate_position(satellites[i], current_unix);
 
                 Vector3 V = Vector3Subtract(sat_pos, O_eci);
                 float dist = Vector3Length(V);
@@ -3617,7 +3965,7 @@ case WND_SCOPE:
                 // check if inside the cone
                 if (cos_theta >= cos_beam_half) {
                     double s_az, s_el;
-                    get_az_el(sat_pos, ctx->gmst_deg, home_location.lat, home_location.lon, home_location.alt, &s_az, &s_el);
+                    observer_look(home, sat_pos, now_sin, now_cos, &s_az, &s_el);
 
                     float s_az_rad = s_az * DEG2RAD;
                     float s_el_rad = s_el * DEG2RAD;
@@ -3640,12 +3988,12 @@ case WND_SCOPE:
                     if (cfg->highlight_sunlit) {
                         bool eclipsed = is_sat_eclipsed(sat_pos, sun_dir);
                         dotColor = eclipsed ? GRAY : GOLD;
-                        if (!satellites[i].is_active) dotColor = ApplyAlpha(dotColor, 0.65f);
+                        if (!sat_active[i]) dotColor = ApplyAlpha(dotColor, 0.65f);
                     } else {
-                        dotColor = satellites[i].is_active ? cfg->ui_accent : ApplyAlpha(cfg->text_secondary, 0.9f);
+                        dotColor = sat_active[i] ? cfg->ui_accent : ApplyAlpha(cfg->text_secondary, 0.9f);
                     }
 
-                    if (*ctx->selected_sat == &satellites[i]) {
+                    if (*ctx->selected_sat == satellites[i]) {
                         DrawCircleV(dot_pos, 4.0f * cfg->ui_scale, cfg->sat_selected);
                     } else {
                         DrawCircleV(dot_pos, 2.0f * cfg->ui_scale, dotColor);
@@ -3653,9 +4001,9 @@ case WND_SCOPE:
 
                     // draw movement vectors if requested
                     if (scope_show_trails) {
-                        Vector3 past_pos = calculate_position(&satellites[i], past_unix);
+                        Vector3 past_pos = calculate_position(satellites[i], past_unix);
                         double p_az, p_el;
-                        get_az_el(past_pos, past_gmst, home_location.lat, home_location.lon, home_location.alt, &p_az, &p_el);
+                        observer_look(home, past_pos, past_sin, past_cos, &p_az, &p_el);
 
                         float p_az_rad = p_az * DEG2RAD;
                         float p_el_rad = p_el * DEG2RAD;
@@ -3687,7 +4035,7 @@ case WND_SCOPE:
                     float hover_dist = Vector2Distance(GetMousePosition(), dot_pos);
                     if (hover_dist < 8.0f * cfg->ui_scale && hover_dist < min_hover_dist) {
                         min_hover_dist = hover_dist;
-                        hover_sat_scope = &satellites[i];
+                        hover_sat_scope = satellites[i];
                         hover_pos = dot_pos;
                     }
                 }
@@ -3732,10 +4080,10 @@ case WND_SCOPE:
 
             // visibility toggle for quick additions to satellite manager
             if (!*ctx->selected_sat) GuiDisable();
-            bool is_vis = *ctx->selected_sat && (*ctx->selected_sat)->is_active;
+            bool is_vis = *ctx->selected_sat && sat_active[(*ctx->selected_sat)->id];
             if (GuiButton((Rectangle){sc_x + scopeWindow.width - 39 * cfg->ui_scale, ctrl_y, 24 * cfg->ui_scale, 24 * cfg->ui_scale}, is_vis ? "#44#" : "#45#")) {
                 if (*ctx->selected_sat) {
-                    (*ctx->selected_sat)->is_active = !(*ctx->selected_sat)->is_active;
+                    sat_active[(*ctx->selected_sat)->id] = !sat_active[(*ctx->selected_sat)->id];
                     SaveSatSelection();
                 }
             }
@@ -3814,20 +4162,21 @@ case WND_SCOPE:
             if (*ctx->selected_sat)
             {
                 Satellite *sat = *ctx->selected_sat;
-                double r_km = Vector3Length(sat->current_pos);
+                double r_km = Vector3Length(sat_current_pos[sat->id]);
                 double v_kms = sqrt(MU * (2.0 / r_km - 1.0 / sat->semi_major_axis));
-                float lat_deg = asinf(sat->current_pos.y / r_km) * RAD2DEG;
-                float lon_deg = (atan2f(-sat->current_pos.z, sat->current_pos.x) - ((ctx->gmst_deg + cfg->earth_rotation_offset) * DEG2RAD)) * RAD2DEG;
+                float lat_deg = asinf(sat_current_pos[sat->id].y / r_km) * RAD2DEG;
+                float lon_deg = (atan2f(-sat_current_pos[sat->id].z, sat_current_pos[sat->id].x) - ((ctx->gmst_deg + cfg->earth_rotation_offset) * DEG2RAD)) * RAD2DEG;
                 while (lon_deg > 180.0f) lon_deg -= 360.0f;
                 while (lon_deg < -180.0f) lon_deg += 360.0f;
 
                 Vector3 sun_pos = calculate_sun_position(*ctx->current_epoch);
                 Vector3 sun_dir = Vector3Normalize(sun_pos);
-                bool eclipsed = is_sat_eclipsed(sat->current_pos, sun_dir);
+                bool eclipsed = is_sat_eclipsed(sat_current_pos[sat->id], sun_dir);
 
                 double c_az, c_el;
-                get_az_el(sat->current_pos, ctx->gmst_deg, home_location.lat, home_location.lon, home_location.alt, &c_az, &c_el);
-                double s_range = get_sat_range(sat, *ctx->current_epoch, home_location);
+                get_az_el(sat_current_pos[sat->id], ctx->gmst_deg, home_location.lat, home_location.lon, home_location.alt, &c_az, &c_el);
+                double s_range;
+                double range_rate = get_sat_range_rate(sat, *ctx->current_epoch, home_location, &s_range);
 
                 double t_peri_unix, t_apo_unix;
                 get_apsis_times(sat, *ctx->current_epoch, &t_peri_unix, &t_apo_unix);
@@ -3837,11 +4186,6 @@ case WND_SCOPE:
                 double period_min = (2.0 * PI / sat->mean_motion) / 60.0;
                 double revs_per_day = (sat->mean_motion * 86400.0) / (2.0 * PI);
 
-                double dt = 0.1 / 86400.0;
-                double r1 = get_sat_range(sat, *ctx->current_epoch - dt, home_location);
-                double r2 = get_sat_range(sat, *ctx->current_epoch + dt, home_location);
-                double range_rate = (r2 - r1) / 0.2;
-
                 Rectangle contentRec = {0, 0, satInfoWindow.width - 32 * cfg->ui_scale, 580 * cfg->ui_scale};
                 Rectangle viewRec = {0};
 
@@ -4179,10 +4523,10 @@ case WND_SCOPE:
         int cached_count = 0;
         for (int i = 0; i < sat_count; i++)
         {
-            if (satellites[i].is_active)
+            if (sat_active[i])
             {
                 active_render_count++;
-                if (satellites[i].orbit_cached)
+                if (satellites[i]->orbit_cache)
                     cached_count++;
             }
         }
@@ -4205,17 +4549,37 @@ case WND_SCOPE:
         DrawUIText(customFont, TextFormat("%3i FPS", GetFPS()), stats_x, 10 * cfg->ui_scale, 20 * cfg->ui_scale, cfg->ui_accent);
         DrawUIText(customFont, TextFormat("%i Sats (%i active)", sat_count, active_render_count), stats_x, 34 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
         DrawUIText(customFont, TextFormat("Orbit Step: %i", global_orbit_step), stats_x, 52 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
-        DrawUIText(customFont, TextFormat("Cache: %i/%i", cached_count, active_render_count), stats_x, 70 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
+        size_t pool_mem = get_orbit_cache_pool_bytes();
+        DrawUIText(customFont, TextFormat("Cache: %i/%i (%.1f/%i MB, %i pts, %i queued)", cached_count, active_render_count, pool_mem / (1024.0f * 1024.0f), cfg->orbit_cache_budget_mb, prop_stats.orbit_points, prop_stats.orbit_backlog), stats_x, 70 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
 
-        size_t sat_mem = sat_count * sizeof(Satellite);
+        size_t sat_mem = sat_count * (sizeof(Satellite) + sizeof(bool) + sizeof(Vector3) + sizeof(Vector2)) + pool_mem;
         DrawUIText(customFont, TextFormat("Mem: %.2f MB", sat_mem / (1024.0f * 1024.0f)), stats_x, 88 * cfg->ui_scale, 16 * cfg->ui_scale, cfg->text_secondary);
 
-        int prop_per_sec = GetFPS() * 50; // based on the 50-sat async step in main.c
+        int prop_per_sec = GetFPS() * (prop_stats.near_active + prop_stats.deep_active);
         DrawUIText(customFont, TextFormat("Prop Rate: %i/s", prop_per_sec), stats_x, 106 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->text_secondary);
+        DrawUIText(customFont, TextFormat("Near-Earth: %i (%i active) %.2f ms", prop_stats.near_count, prop_stats.near_active, prop_stats.near_ms), stats_x, 122 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->text_secondary);
+        DrawUIText(customFont, TextFormat("Deep Space: %i (%i active) %.2f ms", prop_stats.deep_count, prop_stats.deep_active, prop_stats.deep_ms), stats_x, 138 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->text_secondary);
+        DrawUIText(customFont, TextFormat("Ephemeris: %i windows, max err %.1f m (tol %.1f m)", prop_stats.ephem_windows, prop_stats.ephem_max_error_km * 1000.0f, cfg->ephemeris_tolerance_km * 1000.0f), stats_x, 154 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->text_secondary);
 
         Vector3 sun_pos = calculate_sun_position(*ctx->current_epoch);
-        DrawUIText(customFont, TextFormat("GMST: %.4f deg", ctx->gmst_deg), stats_x, 128 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->ui_accent);
-        DrawUIText(customFont, TextFormat("Sun ECI: %.3f, %.3f, %.3f", sun_pos.x, sun_pos.y, sun_pos.z), stats_x, 144 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->ui_accent);
+        DrawUIText(customFont, TextFormat("Passes: %i sats searched, %i ruled out by prefilter", prop_stats.pass_candidates - prop_stats.pass_rejected, prop_stats.pass_rejected), stats_x, 170 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->text_secondary);
+
+        DrawUIText(customFont, TextFormat("GMST: %.4f deg", ctx->gmst_deg), stats_x, 192 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->ui_accent);
+        DrawUIText(customFont, TextFormat("Sun ECI: %.3f, %.3f, %.3f", sun_pos.x, sun_pos.y, sun_pos.z), stats_x, 208 * cfg->ui_scale, 14 * cfg->ui_scale, cfg->ui_accent);
+    }
+
+    /* whatever the task queue is chewing on, centered above the status row */
+    float task_progress = 0.0f;
+    const char *task_label = TaskGetActive(&task_progress);
+    if (task_label)
+    {
+        const char *task_text = TextFormat("%s... %i%%", task_label, (int)(task_progress * 100.0f));
+        float task_w = MeasureTextEx(customFont, task_text, 14 * cfg->ui_scale, 1.0f).x;
+        float task_x = (GetScreenWidth() - task_w) / 2.0f;
+        float task_y = GetScreenHeight() - 95 * cfg->ui_scale;
+        DrawUIText(customFont, task_text, task_x, task_y, 14 * cfg->ui_scale, cfg->text_secondary);
+        DrawRectangle(task_x, task_y + 18 * cfg->ui_scale, task_w, 2 * cfg->ui_scale, ApplyAlpha(cfg->ui_secondary, 0.5f));
+        DrawRectangle(task_x, task_y + 18 * cfg->ui_scale, task_w * task_progress, 2 * cfg->ui_scale, cfg->ui_accent);
     }
 
     bool show_real_time = (*ctx->time_multiplier == 1.0 && fabs(*ctx->current_epoch - get_current_real_time_epoch()) < (5.0 / 86400.0) && !*ctx->is_auto_warping);
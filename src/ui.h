@@ -46,6 +46,8 @@ typedef struct
 /* core UI Methods */
 void SaveSatSelection(void);
 void LoadSatSelection(void);
+void SavePassCache(void);
+void LoadPassCache(void);
 bool IsUITyping(void);
 void ToggleTLEWarning(void);
 bool IsMouseOverUI(AppConfig *cfg);
@@ -55,7 +57,6 @@ void DrawGUI(UIContext *ctx, AppConfig *cfg, Font customFont);
 Color ApplyAlpha(Color c, float alpha);
 void DrawUIText(Font font, const char *text, float x, float y, float size, Color color);
 double StepTimeMultiplier(double current, bool increase);
-double unix_to_epoch(double target_unix);
 bool IsOccludedByEarth(Vector3 camPos, Vector3 targetPos, float earthRadius);
 
 #endif // UI_H
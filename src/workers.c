@@ -0,0 +1,260 @@
+#define _GNU_SOURCE
+#include "workers.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/* persistent pool; the calling thread always helps out, so N workers means N+1 lanes of work */
+static pthread_t worker_threads[MAX_WORKER_THREADS];
+static int worker_count = 0;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_work_cv = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done_cv = PTHREAD_COND_INITIALIZER;
+static unsigned int pool_generation = 0;
+static int pool_finished = 0;
+static bool pool_quit = false;
+
+/* current job, only written under pool_lock while every worker is parked */
+static WorkerJobFn job_fn = NULL;
+static void *job_user = NULL;
+static int job_count = 0;
+static int job_chunk = 1;
+static int job_num_chunks = 0;
+static volatile int job_next_chunk = 0;
+
+int WorkerPoolDetectCores(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/* grabs chunks off the shared counter until there's nothing left */
+static void RunChunks(void)
+{
+    while (1)
+    {
+        int c = __sync_fetch_and_add(&job_next_chunk, 1);
+        if (c >= job_num_chunks)
+            break;
+        int start = c * job_chunk;
+        int end = start + job_chunk;
+        if (end > job_count)
+            end = job_count;
+        job_fn(job_user, start, end);
+    }
+}
+
+static void *WorkerMain(void *arg)
+{
+    (void)arg;
+    unsigned int seen = 0;
+
+    while (1)
+    {
+        pthread_mutex_lock(&pool_lock);
+        while (!pool_quit && seen == pool_generation)
+            pthread_cond_wait(&pool_work_cv, &pool_lock);
+        if (pool_quit)
+        {
+            pthread_mutex_unlock(&pool_lock);
+            break;
+        }
+        seen = pool_generation;
+        pthread_mutex_unlock(&pool_lock);
+
+        RunChunks();
+
+        /* every worker checks in for every job, so nobody can wander into the next one half-asleep */
+        pthread_mutex_lock(&pool_lock);
+        if (++pool_finished == worker_count)
+            pthread_cond_signal(&pool_done_cv);
+        pthread_mutex_unlock(&pool_lock);
+    }
+    return NULL;
+}
+
+/* thread_count <= 0 means one thread per core (minus the main thread) */
+void WorkerPoolInit(int thread_count)
+{
+    if (worker_count > 0)
+        return;
+
+    if (thread_count <= 0)
+        thread_count = WorkerPoolDetectCores() - 1;
+    if (thread_count > MAX_WORKER_THREADS)
+        thread_count = MAX_WORKER_THREADS;
+
+    pool_quit = false;
+    for (int i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&worker_threads[worker_count], NULL, WorkerMain, NULL) != 0)
+        {
+            printf("Failed to start worker thread %d, continuing with %d.\n", i, worker_count);
+            break;
+        }
+        worker_count++;
+    }
+}
+
+void WorkerPoolShutdown(void)
+{
+    pthread_mutex_lock(&pool_lock);
+    pool_quit = true;
+    pthread_cond_broadcast(&pool_work_cv);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (int i = 0; i < worker_count; i++)
+        pthread_join(worker_threads[i], NULL);
+    worker_count = 0;
+}
+
+int WorkerPoolThreadCount(void)
+{
+    return worker_count;
+}
+
+/* splits [0, count) into chunks of at least min_chunk items and blocks until all of them ran */
+void WorkerPoolParallelFor(int count, int min_chunk, WorkerJobFn fn, void *user)
+{
+    if (count <= 0)
+        return;
+    if (min_chunk < 1)
+        min_chunk = 1;
+
+    /* not worth waking anybody up */
+    if (worker_count == 0 || count <= min_chunk)
+    {
+        fn(user, 0, count);
+        return;
+    }
+
+    /* a few chunks per lane so one slow chunk (deep space sats, etc.) doesn't stall the join */
+    int lanes = worker_count + 1;
+    int chunk = (count + lanes * 4 - 1) / (lanes * 4);
+    if (chunk < min_chunk)
+        chunk = min_chunk;
+
+    pthread_mutex_lock(&pool_lock);
+    job_fn = fn;
+    job_user = user;
+    job_count = count;
+    job_chunk = chunk;
+    job_num_chunks = (count + chunk - 1) / chunk;
+    __sync_synchronize();
+    job_next_chunk = 0;
+    pool_finished = 0;
+    pool_generation++;
+    pthread_cond_broadcast(&pool_work_cv);
+    pthread_mutex_unlock(&pool_lock);
+
+    RunChunks();
+
+    pthread_mutex_lock(&pool_lock);
+    while (pool_finished < worker_count)
+        pthread_cond_wait(&pool_done_cv, &pool_lock);
+    pthread_mutex_unlock(&pool_lock);
+}
+
+struct WorkerThread
+{
+    pthread_t handle;
+    WorkerThreadFn fn;
+    void *arg;
+};
+
+struct WorkerMutex
+{
+    pthread_mutex_t handle;
+};
+
+static void *WorkerThreadEntry(void *arg)
+{
+    WorkerThread *t = (WorkerThread *)arg;
+    t->fn(t->arg);
+    return NULL;
+}
+
+WorkerThread *WorkerSpawn(WorkerThreadFn fn, void *arg)
+{
+    WorkerThread *t = (WorkerThread *)malloc(sizeof(WorkerThread));
+    if (!t)
+        return NULL;
+    t->fn = fn;
+    t->arg = arg;
+    if (pthread_create(&t->handle, NULL, WorkerThreadEntry, t) != 0)
+    {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void WorkerJoin(WorkerThread *thread)
+{
+    if (!thread)
+        return;
+    pthread_join(thread->handle, NULL);
+    free(thread);
+}
+
+void WorkerSleepMs(int ms)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    Sleep(ms);
+#else
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/* monotonic, only good for measuring intervals */
+double WorkerClockMs(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+WorkerMutex *WorkerMutexCreate(void)
+{
+    WorkerMutex *m = (WorkerMutex *)malloc(sizeof(WorkerMutex));
+    if (m)
+        pthread_mutex_init(&m->handle, NULL);
+    return m;
+}
+
+void WorkerMutexLock(WorkerMutex *m)
+{
+    if (m)
+        pthread_mutex_lock(&m->handle);
+}
+
+void WorkerMutexUnlock(WorkerMutex *m)
+{
+    if (m)
+        pthread_mutex_unlock(&m->handle);
+}
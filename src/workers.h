@@ -0,0 +1,28 @@
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#define MAX_WORKER_THREADS 64
+
+/* job callback for WorkerPoolParallelFor; handles items [start, end) */
+typedef void (*WorkerJobFn)(void *user, int start, int end);
+
+void WorkerPoolInit(int thread_count);
+void WorkerPoolShutdown(void);
+int WorkerPoolThreadCount(void);
+int WorkerPoolDetectCores(void);
+void WorkerPoolParallelFor(int count, int min_chunk, WorkerJobFn fn, void *user);
+
+/* long-lived background threads and plain mutexes, so nothing else has to include pthread.h */
+typedef struct WorkerThread WorkerThread;
+typedef struct WorkerMutex WorkerMutex;
+typedef void (*WorkerThreadFn)(void *arg);
+
+WorkerThread *WorkerSpawn(WorkerThreadFn fn, void *arg);
+void WorkerJoin(WorkerThread *thread);
+void WorkerSleepMs(int ms);
+double WorkerClockMs(void);
+WorkerMutex *WorkerMutexCreate(void);
+void WorkerMutexLock(WorkerMutex *m);
+void WorkerMutexUnlock(WorkerMutex *m);
+
+#endif // WORKERS_H